@@ -490,6 +490,7 @@ int _show_death(Object* obj, int anim)
 
     if (!_critter_flag_check(obj->pid, CRITTER_FLAT)) {
         obj->flags |= OBJECT_NO_BLOCK;
+        objectInvalidateBlocking(obj->elevation);
         if (_obj_toggle_flat(obj, &tempRect) == 0) {
             rectUnion(&dirtyRect, &tempRect, &dirtyRect);
         }
@@ -19,6 +19,7 @@
 #include "item.h"
 #include "kb.h"
 #include "map.h"
+#include "memory.h"
 #include "mouse.h"
 #include "object.h"
 #include "party_member.h"
@@ -233,8 +234,63 @@ typedef struct PathNode {
     int rotation;
     int estimate;
     int cost;
+    // CE: Index of the node for [from] tile in closed list.
+    int fromIndex;
 } PathNode;
 
+#define PATH_NODE_CAPACITY 10000
+
+// State of a single path search.
+//
+// In the original code this state is kept in global lists, and the best open
+// node and a free slot for new one are looked up with linear scans. Open nodes
+// are still kept in slots, but they are also organized in a binary heap
+// ordered by total cost and then by slot index. Free slots are reused
+// lowest first, so the search visits nodes in exactly the same order as the
+// original one.
+typedef struct PathfinderContext {
+    PathNode closedNodes[PATH_NODE_CAPACITY];
+    int closedNodesLength;
+
+    PathNode openNodes[PATH_NODE_CAPACITY];
+
+    // Binary min-heap of occupied slots in [openNodes].
+    int openHeap[PATH_NODE_CAPACITY];
+    int openHeapLength;
+
+    // Binary min-heap of free slots in [openNodes] below [openNodesUsed].
+    int freeSlots[PATH_NODE_CAPACITY];
+    int freeSlotsLength;
+
+    // Number of slots in [openNodes] ever occupied during current search.
+    int openNodesUsed;
+
+    unsigned char processedTiles[5000];
+} PathfinderContext;
+
+#define PATH_CACHE_CAPACITY 16
+#define PATH_CACHE_ROTATIONS_CAPACITY 800
+
+// Result of a recent [pathfinderFindPath] search with [_obj_blocking_at]
+// predicate. Entry is valid as long as blocking generation of its elevation
+// remains the same and the same object (if any) is temporarily ignored via
+// [objectBeginIgnoreBlocking].
+typedef struct PathCacheEntry {
+    Object* object;
+    int pid;
+    int fid;
+    int from;
+    int to;
+    int elevation;
+    int a5;
+    bool inCombat;
+    Object* ignored;
+    unsigned int generation;
+    // Path length, or -1 if entry is not used.
+    int length;
+    unsigned char rotations[PATH_CACHE_ROTATIONS_CAPACITY];
+} PathCacheEntry;
+
 // TODO: I don't know what `sad` means, but it's definitely better than
 // `STRUCT_530014`. Find a better name.
 typedef struct AnimationSad {
@@ -290,6 +346,8 @@ static int _check_gravity(int tile, int elevation);
 static unsigned int animationComputeTicksPerFrame(Object* object, int fid);
 
 static void reportOverloaded(Object* critter);
+static void pathCacheClear();
+static int pathfinderFindPathInContext(PathfinderContext* context, Object* object, int from, int to, unsigned char* rotations, int a5, PathBuilderCallback* callback);
 
 // 0x510718
 static int gAnimationCurrentSad = 0;
@@ -309,19 +367,24 @@ static bool _anim_in_bk = false;
 // 0x530014
 static AnimationSad gAnimationSads[ANIMATION_SAD_LIST_CAPACITY];
 
-#define PATH_NODE_CAPACITY 10000
-
-// 0x542FD4
-static PathNode gClosedPathNodeList[PATH_NODE_CAPACITY];
-
 // 0x54CC14
 static AnimationSequence gAnimationSequences[32];
 
-// 0x561814
-static unsigned char gPathfinderProcessedTiles[5000];
+// Context for path searches issued via [pathfinderFindPath].
+static PathfinderContext gPathfinderContext;
+
+static PathCacheEntry gPathCache[PATH_CACHE_CAPACITY];
 
-// 0x562B9C
-static PathNode gOpenPathNodeList[PATH_NODE_CAPACITY];
+// Index of [gPathCache] entry to be replaced next.
+static int gPathCacheNextIndex = 0;
+
+static unsigned int gPathCacheHits = 0;
+static unsigned int gPathCacheMisses = 0;
+
+// Subset of the above for searches made by critters other than the dude
+// during combat (i.e. during AI turns).
+static unsigned int gPathCacheAiHits = 0;
+static unsigned int gPathCacheAiMisses = 0;
 
 // 0x56C7DC
 static int gAnimationDescriptionCurrentIndex;
@@ -350,6 +413,8 @@ void animationReset()
         gAnimationSequences[index].step = ANIM_COMPLETE;
         gAnimationSequences[index].flags = 0;
     }
+
+    pathCacheClear();
 }
 
 // 0x413AB8
@@ -357,6 +422,8 @@ void animationExit()
 {
     // NOTE: Uninline.
     animationStop();
+
+    pathCachePrintStats();
 }
 
 // 0x413AF4
@@ -1718,9 +1785,202 @@ int _make_path(Object* object, int from, int to, unsigned char* rotations, int a
     return pathfinderFindPath(object, from, to, rotations, a5, _obj_blocking_at);
 }
 
+// Returns `true` if open node in [slot1] should be expanded before the one in
+// [slot2].
+static bool pathfinderOpenNodeLess(PathfinderContext* context, int slot1, int slot2)
+{
+    PathNode* node1 = &(context->openNodes[slot1]);
+    PathNode* node2 = &(context->openNodes[slot2]);
+    int total1 = node1->estimate + node1->cost;
+    int total2 = node2->estimate + node2->cost;
+    if (total1 != total2) {
+        return total1 < total2;
+    }
+    return slot1 < slot2;
+}
+
+static void pathfinderOpenHeapPush(PathfinderContext* context, int slot)
+{
+    int index = context->openHeapLength++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!pathfinderOpenNodeLess(context, slot, context->openHeap[parent])) {
+            break;
+        }
+        context->openHeap[index] = context->openHeap[parent];
+        index = parent;
+    }
+    context->openHeap[index] = slot;
+}
+
+static int pathfinderOpenHeapPop(PathfinderContext* context)
+{
+    int top = context->openHeap[0];
+    int slot = context->openHeap[--context->openHeapLength];
+
+    int index = 0;
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= context->openHeapLength) {
+            break;
+        }
+
+        if (child + 1 < context->openHeapLength && pathfinderOpenNodeLess(context, context->openHeap[child + 1], context->openHeap[child])) {
+            child++;
+        }
+
+        if (!pathfinderOpenNodeLess(context, context->openHeap[child], slot)) {
+            break;
+        }
+
+        context->openHeap[index] = context->openHeap[child];
+        index = child;
+    }
+    context->openHeap[index] = slot;
+
+    return top;
+}
+
+// Returns lowest free slot in open nodes list.
+static int pathfinderAllocateSlot(PathfinderContext* context)
+{
+    if (context->freeSlotsLength == 0) {
+        return context->openNodesUsed++;
+    }
+
+    int* slots = context->freeSlots;
+    int top = slots[0];
+    int slot = slots[--context->freeSlotsLength];
+
+    int index = 0;
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= context->freeSlotsLength) {
+            break;
+        }
+
+        if (child + 1 < context->freeSlotsLength && slots[child + 1] < slots[child]) {
+            child++;
+        }
+
+        if (slots[child] >= slot) {
+            break;
+        }
+
+        slots[index] = slots[child];
+        index = child;
+    }
+    slots[index] = slot;
+
+    return top;
+}
+
+static void pathfinderReleaseSlot(PathfinderContext* context, int slot)
+{
+    int* slots = context->freeSlots;
+    int index = context->freeSlotsLength++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (slots[parent] <= slot) {
+            break;
+        }
+        slots[index] = slots[parent];
+        index = parent;
+    }
+    slots[index] = slot;
+}
+
 // TODO: move pathfinding into another unit
 // 0x415EFC
 int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotations, int a5, PathBuilderCallback* callback)
+{
+    // CE: Results of searches with the default blocking predicate are cached,
+    // since AI and mouse code ask for the same path many times while nothing
+    // moves. Other predicates depend on state not covered by blocking
+    // generation (e.g. `_obj_ai_blocking_at` reports blocker via
+    // `_moveBlockObj`), so they always run the search.
+    if (callback != _obj_blocking_at || !elevationIsValid(object->elevation)) {
+        return pathfinderFindPathInContext(&gPathfinderContext, object, from, to, rotations, a5, callback);
+    }
+
+    int elevation = object->elevation;
+    unsigned int generation = objectGetBlockingGeneration(elevation);
+    bool inCombat = isInCombat();
+    bool aiTurn = inCombat && object != gDude;
+    Object* ignored = objectGetBlockingIgnored();
+
+    for (int index = 0; index < PATH_CACHE_CAPACITY; index++) {
+        PathCacheEntry* entry = &(gPathCache[index]);
+        if (entry->length != -1
+            && entry->object == object
+            && entry->pid == object->pid
+            && entry->fid == object->fid
+            && entry->from == from
+            && entry->to == to
+            && entry->elevation == elevation
+            && entry->a5 == a5
+            && entry->inCombat == inCombat
+            && entry->ignored == ignored
+            && entry->generation == generation) {
+            gPathCacheHits++;
+            if (aiTurn) {
+                gPathCacheAiHits++;
+            }
+
+            if (rotations != nullptr) {
+                memcpy(rotations, entry->rotations, entry->length);
+            }
+
+            return entry->length;
+        }
+    }
+
+    gPathCacheMisses++;
+    if (aiTurn) {
+        gPathCacheAiMisses++;
+    }
+
+    PathCacheEntry* entry = &(gPathCache[gPathCacheNextIndex]);
+    gPathCacheNextIndex = (gPathCacheNextIndex + 1) % PATH_CACHE_CAPACITY;
+
+    int length = pathfinderFindPathInContext(&gPathfinderContext, object, from, to, entry->rotations, a5, callback);
+
+    entry->object = object;
+    entry->pid = object->pid;
+    entry->fid = object->fid;
+    entry->from = from;
+    entry->to = to;
+    entry->elevation = elevation;
+    entry->a5 = a5;
+    entry->inCombat = inCombat;
+    entry->ignored = ignored;
+    entry->generation = generation;
+    entry->length = length;
+
+    if (rotations != nullptr) {
+        memcpy(rotations, entry->rotations, length);
+    }
+
+    return length;
+}
+
+static void pathCacheClear()
+{
+    for (int index = 0; index < PATH_CACHE_CAPACITY; index++) {
+        gPathCache[index].length = -1;
+    }
+
+    gPathCacheNextIndex = 0;
+}
+
+void pathCachePrintStats()
+{
+    debugPrint("Path cache hits: %u, misses: %u\n", gPathCacheHits, gPathCacheMisses);
+    debugPrint("Path cache hits during AI turns: %u, misses: %u\n", gPathCacheAiHits, gPathCacheAiMisses);
+}
+
+// Same as [pathfinderFindPath], but keeps search state in [context].
+static int pathfinderFindPathInContext(PathfinderContext* context, Object* object, int from, int to, unsigned char* rotations, int a5, PathBuilderCallback* callback)
 {
     if (a5) {
         if (callback(object, to, object->elevation) != nullptr) {
@@ -1737,52 +1997,39 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
 
     bool isNotInCombat = !isInCombat();
 
-    memset(gPathfinderProcessedTiles, 0, sizeof(gPathfinderProcessedTiles));
+    memset(context->processedTiles, 0, sizeof(context->processedTiles));
 
-    gPathfinderProcessedTiles[from / 8] |= 1 << (from & 7);
+    context->processedTiles[from / 8] |= 1 << (from & 7);
 
-    gOpenPathNodeList[0].tile = from;
-    gOpenPathNodeList[0].from = -1;
-    gOpenPathNodeList[0].rotation = 0;
-    gOpenPathNodeList[0].estimate = _tile_idistance(from, to);
-    gOpenPathNodeList[0].cost = 0;
+    context->openHeapLength = 0;
+    context->freeSlotsLength = 0;
+    context->openNodesUsed = 0;
+    context->closedNodesLength = 0;
 
-    for (int index = 1; index < PATH_NODE_CAPACITY; index += 1) {
-        gOpenPathNodeList[index].tile = -1;
-    }
+    int startSlot = pathfinderAllocateSlot(context);
+    PathNode* start = &(context->openNodes[startSlot]);
+    start->tile = from;
+    start->from = -1;
+    start->rotation = 0;
+    start->estimate = _tile_idistance(from, to);
+    start->cost = 0;
+    start->fromIndex = -1;
+    pathfinderOpenHeapPush(context, startSlot);
 
     int toScreenX;
     int toScreenY;
     tileToScreenXY(to, &toScreenX, &toScreenY, object->elevation);
 
-    int closedPathNodeListLength = 0;
     int openPathNodeListLength = 1;
     PathNode temp;
 
     while (1) {
-        int v63 = -1;
-
-        PathNode* prev = nullptr;
-        int v12 = 0;
-        for (int index = 0; v12 < openPathNodeListLength; index += 1) {
-            PathNode* curr = &(gOpenPathNodeList[index]);
-            if (curr->tile != -1) {
-                v12++;
-                if (v63 == -1 || (curr->estimate + curr->cost) < (prev->estimate + prev->cost)) {
-                    prev = curr;
-                    v63 = index;
-                }
-            }
-        }
-
-        PathNode* curr = &(gOpenPathNodeList[v63]);
-
-        memcpy(&temp, curr, sizeof(temp));
+        int slot = pathfinderOpenHeapPop(context);
+        memcpy(&temp, &(context->openNodes[slot]), sizeof(temp));
+        pathfinderReleaseSlot(context, slot);
 
         openPathNodeListLength -= 1;
 
-        curr->tile = -1;
-
         if (temp.tile == to) {
             if (openPathNodeListLength == 0) {
                 openPathNodeListLength = 1;
@@ -1790,12 +2037,12 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
             break;
         }
 
-        PathNode* curr1 = &(gClosedPathNodeList[closedPathNodeListLength]);
-        memcpy(curr1, &temp, sizeof(temp));
+        int tempIndex = context->closedNodesLength;
+        memcpy(&(context->closedNodes[tempIndex]), &temp, sizeof(temp));
 
-        closedPathNodeListLength += 1;
+        context->closedNodesLength += 1;
 
-        if (closedPathNodeListLength == PATH_NODE_CAPACITY) {
+        if (context->closedNodesLength == PATH_NODE_CAPACITY) {
             // Search path node capacity exhausted
             return 0;
         }
@@ -1803,7 +2050,7 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
         for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
             int tile = tileGetTileInDirection(temp.tile, rotation, 1);
             int bit = 1 << (tile & 7);
-            if ((gPathfinderProcessedTiles[tile / 8] & bit) != 0) {
+            if ((context->processedTiles[tile / 8] & bit) != 0) {
                 continue;
             }
 
@@ -1816,25 +2063,20 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
                 }
             }
 
-            int v25 = 0;
-            for (; v25 < PATH_NODE_CAPACITY; v25++) {
-                if (gOpenPathNodeList[v25].tile == -1) {
-                    break;
-                }
-            }
-
             openPathNodeListLength += 1;
 
             if (openPathNodeListLength == PATH_NODE_CAPACITY) {
                 return 0;
             }
 
-            gPathfinderProcessedTiles[tile / 8] |= bit;
+            context->processedTiles[tile / 8] |= bit;
 
-            PathNode* v27 = &(gOpenPathNodeList[v25]);
+            int v25 = pathfinderAllocateSlot(context);
+            PathNode* v27 = &(context->openNodes[v25]);
             v27->tile = tile;
             v27->from = temp.tile;
             v27->rotation = rotation;
+            v27->fromIndex = tempIndex;
 
             int newX;
             int newY;
@@ -1864,6 +2106,9 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
                     }
                 }
             }
+
+            // Node is pushed once its cost is final.
+            pathfinderOpenHeapPush(context, v25);
         }
 
         if (openPathNodeListLength == 0) {
@@ -1884,12 +2129,7 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
                 v39 += 1;
             }
 
-            int j = 0;
-            while (gClosedPathNodeList[j].tile != temp.from) {
-                j++;
-            }
-
-            PathNode* v36 = &(gClosedPathNodeList[j]);
+            PathNode* v36 = &(context->closedNodes[temp.fromIndex]);
             memcpy(&temp, v36, sizeof(temp));
         }
 
@@ -2153,12 +2393,14 @@ int _make_straight_path_func(Object* obj, int from, int to, StraightPathNode* st
 static int animateMoveObjectToObject(Object* from, Object* to, int actionPoints, int anim, int animationSequenceIndex)
 {
     bool hidden = (to->flags & OBJECT_HIDDEN);
-    to->flags |= OBJECT_HIDDEN;
+    if (!hidden) {
+        objectBeginIgnoreBlocking(to);
+    }
 
     int moveSadIndex = _anim_move(from, to->tile, to->elevation, -1, anim, 0, animationSequenceIndex);
 
     if (!hidden) {
-        to->flags &= ~OBJECT_HIDDEN;
+        objectEndIgnoreBlocking(to);
     }
 
     if (moveSadIndex == -1) {
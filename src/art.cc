@@ -35,12 +35,22 @@ typedef struct HeadDescription {
     int badFidgetCount;
 } HeadDescription;
 
+// Stream left open by the cache size proc for the subsequent read proc, so
+// that every art cache miss opens and inflates the file only once.
+typedef struct ArtPendingLoad {
+    int fid;
+    File* stream;
+    Art header;
+} ArtPendingLoad;
+
 static int artReadList(const char* path, char** out_arr, int* out_count);
 static int artCacheGetFileSizeImpl(int fid, int* out_size);
 static int artCacheReadDataImpl(int fid, int* sizePtr, unsigned char* data);
 static void artCacheFreeImpl(void* ptr);
 static int artReadFrameData(unsigned char* data, File* stream, int count, int* paddingPtr);
 static int artReadHeader(Art* art, File* stream);
+static int artReadFrames(Art* art, File* stream);
+static void artPendingLoadReset();
 static int artGetDataSize(Art* art);
 static int paddingForSize(int size);
 
@@ -135,6 +145,8 @@ static int* gArtCritterFidShoudRunData;
 // Number of “core” entries per objectType, before we append variants
 static int gArtOriginalCount[OBJ_TYPE_COUNT] = { 0 };
 
+static ArtPendingLoad gArtPendingLoad = { -1, nullptr };
+
 int artGetFidWithVariant(int objectType, int baseId, const char* suffix, bool useVariant)
 {
     if (useVariant) {
@@ -596,6 +608,7 @@ void artReset()
 void artExit()
 {
     cacheFree(&gArtCache);
+    artPendingLoadReset();
 
     internal_free(_anon_alias);
     internal_free(gArtCritterFidShoudRunData);
@@ -1243,14 +1256,21 @@ int artAliasFid(int fid)
     return -1;
 }
 
+// NOTE: In addition to obtaining the size this function keeps the stream
+// positioned right after the header, so that [artCacheReadDataImpl] which the
+// cache calls next can read the frames without reopening the file.
+//
 // 0x419A78
 static int artCacheGetFileSizeImpl(int fid, int* sizePtr)
 {
     int result = -1;
 
+    // Cache did not read the previous entry (it was too big, or there was no
+    // space for it).
+    artPendingLoadReset();
+
     char* artFilePath = artBuildFilePath(fid);
     if (artFilePath != nullptr) {
-        bool loaded = false;
         File* stream = nullptr;
 
         if (gArtLanguageInitialized) {
@@ -1270,12 +1290,14 @@ static int artCacheGetFileSizeImpl(int fid, int* sizePtr)
         }
 
         if (stream != nullptr) {
-            Art art;
-            if (artReadHeader(&art, stream) == 0) {
-                *sizePtr = artGetDataSize(&art);
+            if (artReadHeader(&(gArtPendingLoad.header), stream) == 0) {
+                *sizePtr = artGetDataSize(&(gArtPendingLoad.header));
+                gArtPendingLoad.fid = fid;
+                gArtPendingLoad.stream = stream;
                 result = 0;
+            } else {
+                fileClose(stream);
             }
-            fileClose(stream);
         }
     }
 
@@ -1287,6 +1309,24 @@ static int artCacheReadDataImpl(int fid, int* sizePtr, unsigned char* data)
 {
     int result = -1;
 
+    // Fast path - continue reading the stream opened in
+    // [artCacheGetFileSizeImpl].
+    if (gArtPendingLoad.stream != nullptr && gArtPendingLoad.fid == fid) {
+        Art* art = (Art*)data;
+        memcpy(art, &(gArtPendingLoad.header), sizeof(*art));
+
+        if (artReadFrames(art, gArtPendingLoad.stream) == 0) {
+            *sizePtr = artGetDataSize(art);
+            result = 0;
+        }
+
+        artPendingLoadReset();
+
+        return result;
+    }
+
+    artPendingLoadReset();
+
     char* artFileName = artBuildFilePath(fid);
     if (artFileName != nullptr) {
         bool loaded = false;
@@ -1319,6 +1359,16 @@ static int artCacheReadDataImpl(int fid, int* sizePtr, unsigned char* data)
     return result;
 }
 
+static void artPendingLoadReset()
+{
+    if (gArtPendingLoad.stream != nullptr) {
+        fileClose(gArtPendingLoad.stream);
+        gArtPendingLoad.stream = nullptr;
+    }
+
+    gArtPendingLoad.fid = -1;
+}
+
 // 0x419C80
 static void artCacheFreeImpl(void* ptr)
 {
@@ -1456,6 +1506,20 @@ int artRead(const char* path, unsigned char* data)
         return -3;
     }
 
+    if (artReadFrames(art, stream) != 0) {
+        fileClose(stream);
+        return -5;
+    }
+
+    fileClose(stream);
+    return 0;
+}
+
+// Reads frame data of all rotations following the header. The `art` must be
+// the beginning of the buffer of at least [artGetDataSize] bytes.
+static int artReadFrames(Art* art, File* stream)
+{
+    unsigned char* data = (unsigned char*)art;
     int currentPadding = paddingForSize(sizeof(Art));
     int previousPadding = 0;
 
@@ -1466,13 +1530,11 @@ int artRead(const char* path, unsigned char* data)
             art->padding[index] += previousPadding;
             currentPadding += previousPadding;
             if (artReadFrameData(data + sizeof(Art) + art->dataOffsets[index] + art->padding[index], stream, art->frameCount, &previousPadding) != 0) {
-                fileClose(stream);
-                return -5;
+                return -1;
             }
         }
     }
 
-    fileClose(stream);
     return 0;
 }
 
@@ -53,7 +53,9 @@ static bool defaultCompressionFunc(char* filePath)
 // 0x41A2D0
 static int audioSoundDecoderReadHandler(void* data, void* buffer, unsigned int size)
 {
-    return fileRead(buffer, 1, size, reinterpret_cast<File*>(data));
+    // CE: Decoders are fed from the prefetch thread, which must not reach the
+    // read progress handler.
+    return fileReadRaw(buffer, 1, size, reinterpret_cast<File*>(data));
 }
 
 // AudioOpen
@@ -99,6 +101,9 @@ int audioOpen(const char* fname, int* sampleRate)
     if (compression == 2) {
         audioFile->flags |= AUDIO_COMPRESSED;
         audioFile->soundDecoder = soundDecoderInit(audioSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+        if (audioFile->soundDecoder != nullptr) {
+            soundDecoderStartPrefetch(audioFile->soundDecoder);
+        }
         audioFile->fileSize *= 2;
 
         *sampleRate = audioFile->sampleRate;
@@ -115,12 +120,14 @@ int audioOpen(const char* fname, int* sampleRate)
 int audioClose(int handle)
 {
     Audio* audioFile = &(gAudioList[handle - 1]);
-    fileClose(audioFile->stream);
-
+    // CE: Decoder might be reading from the stream on background thread,
+    // release it first.
     if ((audioFile->flags & AUDIO_COMPRESSED) != 0) {
         soundDecoderFree(audioFile->soundDecoder);
     }
 
+    fileClose(audioFile->stream);
+
     memset(audioFile, 0, sizeof(Audio));
 
     return 0;
@@ -171,6 +178,9 @@ long audioSeek(int handle, long offset, int origin)
             soundDecoderFree(audioFile->soundDecoder);
             fileSeek(audioFile->stream, 0, SEEK_SET);
             audioFile->soundDecoder = soundDecoderInit(audioSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+            if (audioFile->soundDecoder != nullptr) {
+                soundDecoderStartPrefetch(audioFile->soundDecoder);
+            }
             audioFile->position = 0;
             audioFile->fileSize *= 2;
 
@@ -249,6 +259,11 @@ void audioExit()
 
     gAudioListLength = 0;
     gAudioList = nullptr;
+
+    // CE: Stop background decoder shared with `audio_file.cc` (which is shut
+    // down first).
+    soundDecoderPrintStats();
+    soundDecoderPrefetchExit();
 }
 
 } // namespace fallout
@@ -3,12 +3,13 @@
 #include <string.h>
 
 #include <mutex>
+#include <vector>
 
 #include <SDL.h>
 
 namespace fallout {
 
-#define AUDIO_ENGINE_SOUND_BUFFERS 8
+#define AUDIO_ENGINE_SOUND_BUFFERS 16
 
 struct AudioEngineSoundBuffer {
     bool active;
@@ -18,6 +19,7 @@ struct AudioEngineSoundBuffer {
     int rate;
     void* data;
     int volume;
+    int pan;
     bool playing;
     bool looping;
     unsigned int pos;
@@ -29,11 +31,16 @@ extern bool gProgramIsActive;
 
 static bool soundBufferIsValid(int soundBufferIndex);
 static void audioEngineMixin(void* userData, Uint8* stream, int length);
+static void audioEngineMixSoundBuffer(AudioEngineSoundBuffer* soundBuffer, int* bus, int samples);
 
 static SDL_AudioSpec gAudioEngineSpec;
 static SDL_AudioDeviceID gAudioEngineDeviceId = -1;
 static AudioEngineSoundBuffer gAudioEngineSoundBuffers[AUDIO_ENGINE_SOUND_BUFFERS];
 
+// Mixing bus. Every playing sound buffer is accumulated here at full
+// precision and the result is clipped to the device format once.
+static std::vector<int> gAudioEngineMixBus;
+
 static bool audioEngineIsInitialized()
 {
     return gAudioEngineDeviceId != -1;
@@ -52,44 +59,123 @@ static void audioEngineMixin(void* userData, Uint8* stream, int length)
         return;
     }
 
+    int samples = length / sizeof(Sint16);
+    if (gAudioEngineMixBus.size() < static_cast<size_t>(samples)) {
+        gAudioEngineMixBus.resize(samples);
+    }
+
+    int* bus = gAudioEngineMixBus.data();
+    memset(bus, 0, sizeof(*bus) * samples);
+
     for (int index = 0; index < AUDIO_ENGINE_SOUND_BUFFERS; index++) {
         AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[index]);
         std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
 
         if (soundBuffer->active && soundBuffer->playing) {
-            int srcFrameSize = soundBuffer->bitsPerSample / 8 * soundBuffer->channels;
-
-            unsigned char buffer[1024];
-            int pos = 0;
-            while (pos < length) {
-                int remaining = length - pos;
-                if (remaining > sizeof(buffer)) {
-                    remaining = sizeof(buffer);
-                }
+            audioEngineMixSoundBuffer(soundBuffer, bus, samples);
+        }
+    }
 
-                // TODO: Make something better than frame-by-frame convertion.
-                SDL_AudioStreamPut(soundBuffer->stream, (unsigned char*)soundBuffer->data + soundBuffer->pos, srcFrameSize);
-                soundBuffer->pos += srcFrameSize;
+    // Volumes are in `SDL_MIX_MAXVOLUME` units, scale back and clip.
+    Sint16* out = reinterpret_cast<Sint16*>(stream);
+    for (int index = 0; index < samples; index++) {
+        int sample = bus[index] / SDL_MIX_MAXVOLUME;
+        if (sample > SDL_MAX_SINT16) {
+            sample = SDL_MAX_SINT16;
+        } else if (sample < SDL_MIN_SINT16) {
+            sample = SDL_MIN_SINT16;
+        }
+        out[index] = static_cast<Sint16>(sample);
+    }
+}
 
-                int bytesRead = SDL_AudioStreamGet(soundBuffer->stream, buffer, remaining);
-                if (bytesRead == -1) {
-                    break;
-                }
+// Pulls converted samples of a single sound buffer from its stream and
+// accumulates them into the bus with volume and pan applied.
+static void audioEngineMixSoundBuffer(AudioEngineSoundBuffer* soundBuffer, int* bus, int samples)
+{
+    int channels = gAudioEngineSpec.channels;
+    int destFrameSize = sizeof(Sint16) * channels;
+    int srcFrameSize = soundBuffer->bitsPerSample / 8 * soundBuffer->channels;
+
+    // Linear pan law - the opposite side is attenuated, the panned side
+    // stays at full volume. Channels other than front left/right are not
+    // affected.
+    int leftVolume = soundBuffer->volume;
+    int rightVolume = soundBuffer->volume;
+    if (soundBuffer->pan > 0) {
+        leftVolume = leftVolume * (AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT - soundBuffer->pan) / AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT;
+    } else if (soundBuffer->pan < 0) {
+        rightVolume = rightVolume * (soundBuffer->pan - AUDIO_ENGINE_SOUND_BUFFER_PAN_LEFT) / AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT;
+    }
+
+    Sint16 buffer[512];
+    int maxSamples = sizeof(buffer) / sizeof(*buffer) / channels * channels;
+
+    int pos = 0;
+    while (pos < samples) {
+        int remaining = samples - pos;
+        if (remaining > maxSamples) {
+            remaining = maxSamples;
+        }
+
+        int remainingBytes = remaining * sizeof(Sint16);
+
+        // Feed the stream with as much source data as needed to produce the
+        // rest of the output in one go (up to the end of sound buffer),
+        // instead of frame by frame.
+        bool reachedEnd = false;
+        int available = SDL_AudioStreamAvailable(soundBuffer->stream);
+        if (available < remainingBytes) {
+            int destFrames = (remainingBytes - available + destFrameSize - 1) / destFrameSize;
+            unsigned int srcBytes = (unsigned int)((long long)destFrames * soundBuffer->rate / gAudioEngineSpec.freq + 1) * srcFrameSize;
+            if (srcBytes > soundBuffer->size - soundBuffer->pos) {
+                srcBytes = soundBuffer->size - soundBuffer->pos;
+            }
 
-                SDL_MixAudioFormat(stream + pos, buffer, gAudioEngineSpec.format, bytesRead, soundBuffer->volume);
+            SDL_AudioStreamPut(soundBuffer->stream, (unsigned char*)soundBuffer->data + soundBuffer->pos, srcBytes);
+            soundBuffer->pos += srcBytes;
 
-                if (soundBuffer->pos >= soundBuffer->size) {
-                    if (soundBuffer->looping) {
-                        soundBuffer->pos %= soundBuffer->size;
-                    } else {
-                        soundBuffer->playing = false;
-                        break;
-                    }
+            if (soundBuffer->pos >= soundBuffer->size) {
+                if (soundBuffer->looping) {
+                    soundBuffer->pos %= soundBuffer->size;
+                } else {
+                    reachedEnd = true;
                 }
+            }
+        }
+
+        int bytesRead = SDL_AudioStreamGet(soundBuffer->stream, buffer, remainingBytes);
+        if (bytesRead == -1) {
+            break;
+        }
 
-                pos += bytesRead;
+        int samplesRead = bytesRead / sizeof(Sint16);
+        int* dest = bus + pos;
+
+        // Plain loops so that compiler can vectorize them.
+        if (channels == 2) {
+            for (int index = 0; index < samplesRead; index += 2) {
+                dest[index] += buffer[index] * leftVolume;
+                dest[index + 1] += buffer[index + 1] * rightVolume;
+            }
+        } else if (channels == 1) {
+            for (int index = 0; index < samplesRead; index++) {
+                dest[index] += buffer[index] * soundBuffer->volume;
+            }
+        } else {
+            for (int index = 0; index < samplesRead; index++) {
+                int channel = (pos + index) % channels;
+                int volume = channel == 0 ? leftVolume : (channel == 1 ? rightVolume : soundBuffer->volume);
+                dest[index] += buffer[index] * volume;
             }
         }
+
+        if (reachedEnd) {
+            soundBuffer->playing = false;
+            break;
+        }
+
+        pos += samplesRead;
     }
 }
 
@@ -97,16 +183,20 @@ bool audioEngineInit()
 {
     SDL_AudioSpec desiredSpec;
     desiredSpec.freq = 22050;
-    desiredSpec.format = AUDIO_S16;
+    desiredSpec.format = AUDIO_S16SYS;
     desiredSpec.channels = 2;
     desiredSpec.samples = 1024;
     desiredSpec.callback = audioEngineMixin;
 
-    gAudioEngineDeviceId = SDL_OpenAudioDevice(nullptr, 0, &desiredSpec, &gAudioEngineSpec, SDL_AUDIO_ALLOW_ANY_CHANGE);
+    // The mixer works with 16-bit samples only, let SDL convert to the real
+    // device format when needed.
+    gAudioEngineDeviceId = SDL_OpenAudioDevice(nullptr, 0, &desiredSpec, &gAudioEngineSpec, SDL_AUDIO_ALLOW_ANY_CHANGE & ~SDL_AUDIO_ALLOW_FORMAT_CHANGE);
     if (gAudioEngineDeviceId == -1) {
         return false;
     }
 
+    gAudioEngineMixBus.resize(gAudioEngineSpec.samples * gAudioEngineSpec.channels);
+
     SDL_PauseAudioDevice(gAudioEngineDeviceId, 0);
 
     return true;
@@ -117,6 +207,9 @@ void audioEngineExit()
     if (audioEngineIsInitialized()) {
         SDL_CloseAudioDevice(gAudioEngineDeviceId);
         gAudioEngineDeviceId = -1;
+
+        gAudioEngineMixBus.clear();
+        gAudioEngineMixBus.shrink_to_fit();
     }
 }
 
@@ -151,11 +244,12 @@ int audioEngineCreateSoundBuffer(unsigned int size, int bitsPerSample, int chann
             soundBuffer->channels = channels;
             soundBuffer->rate = rate;
             soundBuffer->volume = SDL_MIX_MAXVOLUME;
+            soundBuffer->pan = 0;
             soundBuffer->playing = false;
             soundBuffer->looping = false;
             soundBuffer->pos = 0;
             soundBuffer->data = malloc(size);
-            soundBuffer->stream = SDL_NewAudioStream(bitsPerSample == 16 ? AUDIO_S16 : AUDIO_S8, channels, rate, gAudioEngineSpec.format, gAudioEngineSpec.channels, gAudioEngineSpec.freq);
+            soundBuffer->stream = SDL_NewAudioStream(bitsPerSample == 16 ? AUDIO_S16 : AUDIO_S8, channels, rate, AUDIO_S16SYS, gAudioEngineSpec.channels, gAudioEngineSpec.freq);
             return index;
         }
     }
@@ -252,8 +346,13 @@ bool audioEngineSoundBufferSetPan(int soundBufferIndex, int pan)
         return false;
     }
 
-    // NOTE: Audio engine does not support sound panning. I'm not sure it's
-    // even needed. For now this value is silently ignored.
+    if (pan < AUDIO_ENGINE_SOUND_BUFFER_PAN_LEFT) {
+        pan = AUDIO_ENGINE_SOUND_BUFFER_PAN_LEFT;
+    } else if (pan > AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT) {
+        pan = AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT;
+    }
+
+    soundBuffer->pan = pan;
 
     return true;
 }
@@ -11,6 +11,9 @@ namespace fallout {
 #define AUDIO_ENGINE_SOUND_BUFFER_STATUS_PLAYING 0x00000001
 #define AUDIO_ENGINE_SOUND_BUFFER_STATUS_LOOPING 0x00000004
 
+#define AUDIO_ENGINE_SOUND_BUFFER_PAN_LEFT (-10000)
+#define AUDIO_ENGINE_SOUND_BUFFER_PAN_RIGHT 10000
+
 bool audioEngineInit();
 void audioEngineExit();
 void audioEnginePause();
@@ -97,6 +97,9 @@ int audioFileOpen(const char* fname, int* sampleRate)
     if (compression == 2) {
         audioFile->flags |= AUDIO_FILE_COMPRESSED;
         audioFile->soundDecoder = soundDecoderInit(audioFileSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+        if (audioFile->soundDecoder != nullptr) {
+            soundDecoderStartPrefetch(audioFile->soundDecoder);
+        }
         audioFile->fileSize *= 2;
 
         *sampleRate = audioFile->sampleRate;
@@ -113,12 +116,14 @@ int audioFileOpen(const char* fname, int* sampleRate)
 int audioFileClose(int handle)
 {
     AudioFile* audioFile = &(gAudioFileList[handle - 1]);
-    fclose(audioFile->stream);
-
+    // CE: Decoder might be reading from the stream on background thread,
+    // release it first.
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
         soundDecoderFree(audioFile->soundDecoder);
     }
 
+    fclose(audioFile->stream);
+
     // Reset audio file (which also resets it's use flag).
     memset(audioFile, 0, sizeof(*audioFile));
 
@@ -173,6 +178,9 @@ long audioFileSeek(int handle, long offset, int origin)
             fseek(audioFile->stream, 0, 0);
 
             audioFile->soundDecoder = soundDecoderInit(audioFileSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+            if (audioFile->soundDecoder != nullptr) {
+                soundDecoderStartPrefetch(audioFile->soundDecoder);
+            }
             audioFile->fileSize *= 2;
             audioFile->position = 0;
 
@@ -11,24 +11,30 @@
 
 namespace fallout {
 
-// The initial number of cache entries in new cache.
-#define CACHE_ENTRIES_INITIAL_CAPACITY (100)
-
-// The number of cache entries added when cache capacity is reached.
-#define CACHE_ENTRIES_GROW_CAPACITY (50)
-
-static bool cacheFetchEntryForKey(Cache* cache, int key, int* indexPtr);
-static bool cacheInsertEntryAtIndex(Cache* cache, CacheEntry* cacheEntry, int index);
-static int cacheFindIndexForKey(Cache* cache, int key, int* indexPtr);
+// The initial number of hash buckets in new cache. Must be a power of two.
+#define CACHE_BUCKETS_INITIAL_CAPACITY (128)
+
+static bool cacheFetchEntryForKey(Cache* cache, int key, CacheEntry** cacheEntryPtr);
+static CacheEntry* cacheFindEntryForKey(Cache* cache, int key);
+static bool cacheInsertEntry(Cache* cache, CacheEntry* cacheEntry);
+static void cacheRemoveEntry(Cache* cache, CacheEntry* cacheEntry);
+static bool cacheSetBucketsCapacity(Cache* cache, int newCapacity);
+static void cacheLruAppend(Cache* cache, CacheEntry* cacheEntry);
+static void cacheLruUnlink(Cache* cache, CacheEntry* cacheEntry);
 static bool cacheEntryInit(CacheEntry* cacheEntry);
 static bool cacheEntryFree(Cache* cache, CacheEntry* cacheEntry);
 static bool cacheClean(Cache* cache);
 static bool cacheResetStatistics(Cache* cache);
 static bool cacheEnsureSize(Cache* cache, int size);
 static bool cacheSweep(Cache* cache);
-static bool cacheSetCapacity(Cache* cache, int newCapacity);
-static int cacheEntriesCompareByUsage(const void* a1, const void* a2);
-static int cacheEntriesCompareByMostRecentHit(const void* a1, const void* a2);
+
+static inline unsigned int cacheHashKey(int key)
+{
+    // Fibonacci hashing with a final fold, art fids have most of their
+    // entropy in the low bits, while sound effect tags are sequential.
+    unsigned int hash = (unsigned int)key * 0x9E3779B1U;
+    return hash ^ (hash >> 16);
+}
 
 // 0x510938
 static int _lock_sound_ticker = 0;
@@ -44,18 +50,20 @@ bool cacheInit(Cache* cache, CacheSizeProc* sizeProc, CacheReadProc* readProc, C
     cache->size = 0;
     cache->maxSize = maxSize;
     cache->entriesLength = 0;
-    cache->entriesCapacity = CACHE_ENTRIES_INITIAL_CAPACITY;
+    cache->bucketsLength = CACHE_BUCKETS_INITIAL_CAPACITY;
     cache->hits = 0;
-    cache->entries = (CacheEntry**)internal_malloc(sizeof(*cache->entries) * cache->entriesCapacity);
+    cache->buckets = (CacheEntry**)internal_malloc(sizeof(*cache->buckets) * cache->bucketsLength);
+    cache->lruHead = nullptr;
+    cache->lruTail = nullptr;
     cache->sizeProc = sizeProc;
     cache->readProc = readProc;
     cache->freeProc = freeProc;
 
-    if (cache->entries == nullptr) {
+    if (cache->buckets == nullptr) {
         return false;
     }
 
-    memset(cache->entries, 0, sizeof(*cache->entries) * cache->entriesCapacity);
+    memset(cache->buckets, 0, sizeof(*cache->buckets) * cache->bucketsLength);
 
     return true;
 }
@@ -75,14 +83,16 @@ bool cacheFree(Cache* cache)
     cache->size = 0;
     cache->maxSize = 0;
     cache->entriesLength = 0;
-    cache->entriesCapacity = 0;
+    cache->bucketsLength = 0;
     cache->hits = 0;
 
-    if (cache->entries != nullptr) {
-        internal_free(cache->entries);
-        cache->entries = nullptr;
+    if (cache->buckets != nullptr) {
+        internal_free(cache->buckets);
+        cache->buckets = nullptr;
     }
 
+    cache->lruHead = nullptr;
+    cache->lruTail = nullptr;
     cache->sizeProc = nullptr;
     cache->readProc = nullptr;
     cache->freeProc = nullptr;
@@ -99,19 +109,17 @@ bool cacheLock(Cache* cache, int key, void** data, CacheEntry** cacheEntryPtr)
 
     *cacheEntryPtr = nullptr;
 
-    int index;
-    int rc = cacheFindIndexForKey(cache, key, &index);
-    if (rc == 2) {
+    CacheEntry* cacheEntry = cacheFindEntryForKey(cache, key);
+    if (cacheEntry != nullptr) {
         // Use existing cache entry.
-        CacheEntry* cacheEntry = cache->entries[index];
         cacheEntry->hits++;
-    } else if (rc == 3) {
+    } else {
         // New cache entry is required.
         if (cache->entriesLength >= INT_MAX) {
             return false;
         }
 
-        if (!cacheFetchEntryForKey(cache, key, &index)) {
+        if (!cacheFetchEntryForKey(cache, key, &cacheEntry)) {
             return false;
         }
 
@@ -119,15 +127,15 @@ bool cacheLock(Cache* cache, int key, void** data, CacheEntry** cacheEntryPtr)
         if (_lock_sound_ticker == 0) {
             soundContinueAll();
         }
-    } else {
-        return false;
     }
 
-    CacheEntry* cacheEntry = cache->entries[index];
     if (cacheEntry->referenceCount == 0) {
         if (!heapLock(&(cache->heap), cacheEntry->heapHandleIndex, &(cacheEntry->data))) {
             return false;
         }
+
+        // Referenced entries are not eviction candidates.
+        cacheLruUnlink(cache, cacheEntry);
     }
 
     cacheEntry->referenceCount++;
@@ -160,6 +168,9 @@ bool cacheUnlock(Cache* cache, CacheEntry* cacheEntry)
 
     if (cacheEntry->referenceCount == 0) {
         heapUnlock(&(cache->heap), cacheEntry->heapHandleIndex);
+
+        // The entry has just been used, make it the last one to be evicted.
+        cacheLruAppend(cache, cacheEntry);
     }
 
     return true;
@@ -173,23 +184,15 @@ bool cacheFlush(Cache* cache)
         return false;
     }
 
-    // Loop thru cache entries and mark those with no references for eviction.
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = cache->entries[index];
-        if (cacheEntry->referenceCount == 0) {
-            cacheEntry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-        }
+    // Every entry with no references is in the LRU list, mark them all for
+    // eviction.
+    for (CacheEntry* cacheEntry = cache->lruHead; cacheEntry != nullptr; cacheEntry = cacheEntry->lruNext) {
+        cacheEntry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
     }
 
     // Sweep cache entries marked earlier.
     cacheSweep(cache);
 
-    // Shrink cache entries array if it's too big.
-    int optimalCapacity = cache->entriesLength + CACHE_ENTRIES_GROW_CAPACITY;
-    if (optimalCapacity < cache->entriesCapacity) {
-        cacheSetCapacity(cache, optimalCapacity);
-    }
-
     return true;
 }
 
@@ -207,8 +210,11 @@ bool cachePrintStats(Cache* cache, char* dest, size_t size)
 
 // Fetches entry for the specified key into the cache.
 //
+// The new entry is unreferenced and placed at the most recently used end of
+// the LRU list.
+//
 // 0x4203AC
-static bool cacheFetchEntryForKey(Cache* cache, int key, int* indexPtr)
+static bool cacheFetchEntryForKey(Cache* cache, int key, CacheEntry** cacheEntryPtr)
 {
     CacheEntry* cacheEntry = (CacheEntry*)internal_malloc(sizeof(*cacheEntry));
     if (cacheEntry == nullptr) {
@@ -276,25 +282,12 @@ static bool cacheFetchEntryForKey(Cache* cache, int key, int* indexPtr)
             cacheEntry->size = size;
             cacheEntry->key = key;
 
-            bool isNewKey = true;
-            if (*indexPtr < cache->entriesLength) {
-                if (key < cache->entries[*indexPtr]->key) {
-                    if (*indexPtr == 0 || key > cache->entries[*indexPtr - 1]->key) {
-                        isNewKey = false;
-                    }
-                }
-            }
-
-            if (isNewKey) {
-                if (cacheFindIndexForKey(cache, key, indexPtr) != 3) {
-                    break;
-                }
-            }
-
-            if (!cacheInsertEntryAtIndex(cache, cacheEntry, *indexPtr)) {
+            if (!cacheInsertEntry(cache, cacheEntry)) {
                 break;
             }
 
+            *cacheEntryPtr = cacheEntry;
+
             return true;
         } while (0);
 
@@ -307,68 +300,132 @@ static bool cacheFetchEntryForKey(Cache* cache, int key, int* indexPtr)
     return false;
 }
 
-// 0x4205E8
-static bool cacheInsertEntryAtIndex(Cache* cache, CacheEntry* cacheEntry, int index)
+// Returns cache entry for the given key, or `nullptr` if there is no such
+// entry in cache.
+static CacheEntry* cacheFindEntryForKey(Cache* cache, int key)
+{
+    unsigned int bucket = cacheHashKey(key) & (cache->bucketsLength - 1);
+
+    CacheEntry* cacheEntry = cache->buckets[bucket];
+    while (cacheEntry != nullptr) {
+        if (cacheEntry->key == key) {
+            return cacheEntry;
+        }
+        cacheEntry = cacheEntry->bucketNext;
+    }
+
+    return nullptr;
+}
+
+// Adds new unreferenced entry to the hash index and the LRU list.
+static bool cacheInsertEntry(Cache* cache, CacheEntry* cacheEntry)
 {
-    // Ensure cache have enough space for new entry.
-    if (cache->entriesLength == cache->entriesCapacity - 1) {
-        if (!cacheSetCapacity(cache, cache->entriesCapacity + CACHE_ENTRIES_GROW_CAPACITY)) {
+    // Keep load factor at or below 1 so bucket chains stay short.
+    if (cache->entriesLength >= cache->bucketsLength) {
+        if (!cacheSetBucketsCapacity(cache, cache->bucketsLength * 2)) {
             return false;
         }
     }
 
-    // Move entries below insertion point.
-    memmove(&(cache->entries[index + 1]), &(cache->entries[index]), sizeof(*cache->entries) * (cache->entriesLength - index));
+    unsigned int bucket = cacheHashKey(cacheEntry->key) & (cache->bucketsLength - 1);
+    cacheEntry->bucketNext = cache->buckets[bucket];
+    cache->buckets[bucket] = cacheEntry;
+
+    cacheLruAppend(cache, cacheEntry);
 
-    cache->entries[index] = cacheEntry;
     cache->entriesLength++;
     cache->size += cacheEntry->size;
 
     return true;
 }
 
-// Finds index for given key.
-//
-// Returns 2 if entry already exists in cache, or 3 if entry does not exist. In
-// this case indexPtr represents insertion point.
-//
-// 0x420654
-static int cacheFindIndexForKey(Cache* cache, int key, int* indexPtr)
+// Removes entry from the hash index and the LRU list. The entry itself is not
+// freed.
+static void cacheRemoveEntry(Cache* cache, CacheEntry* cacheEntry)
 {
-    int length = cache->entriesLength;
-    if (length == 0) {
-        *indexPtr = 0;
-        return 3;
+    unsigned int bucket = cacheHashKey(cacheEntry->key) & (cache->bucketsLength - 1);
+
+    CacheEntry** link = &(cache->buckets[bucket]);
+    while (*link != nullptr) {
+        if (*link == cacheEntry) {
+            *link = cacheEntry->bucketNext;
+            break;
+        }
+        link = &((*link)->bucketNext);
     }
 
-    int r = length - 1;
-    int l = 0;
-    int mid;
-    int cmp;
+    cacheEntry->bucketNext = nullptr;
 
-    do {
-        mid = (l + r) / 2;
+    if (cacheEntry->referenceCount == 0) {
+        cacheLruUnlink(cache, cacheEntry);
+    }
 
-        cmp = key - cache->entries[mid]->key;
-        if (cmp == 0) {
-            *indexPtr = mid;
-            return 2;
-        }
+    cache->entriesLength--;
+    cache->size -= cacheEntry->size;
+}
+
+// Resizes hash index and redistributes entries.
+static bool cacheSetBucketsCapacity(Cache* cache, int newCapacity)
+{
+    CacheEntry** buckets = (CacheEntry**)internal_malloc(sizeof(*buckets) * newCapacity);
+    if (buckets == nullptr) {
+        return false;
+    }
+
+    memset(buckets, 0, sizeof(*buckets) * newCapacity);
 
-        if (cmp > 0) {
-            l = l + 1;
-        } else {
-            r = r - 1;
+    for (int index = 0; index < cache->bucketsLength; index++) {
+        CacheEntry* cacheEntry = cache->buckets[index];
+        while (cacheEntry != nullptr) {
+            CacheEntry* next = cacheEntry->bucketNext;
+
+            unsigned int bucket = cacheHashKey(cacheEntry->key) & (newCapacity - 1);
+            cacheEntry->bucketNext = buckets[bucket];
+            buckets[bucket] = cacheEntry;
+
+            cacheEntry = next;
         }
-    } while (r >= l);
+    }
+
+    internal_free(cache->buckets);
+
+    cache->buckets = buckets;
+    cache->bucketsLength = newCapacity;
+
+    return true;
+}
+
+// Appends entry to the most recently used end of the LRU list.
+static void cacheLruAppend(Cache* cache, CacheEntry* cacheEntry)
+{
+    cacheEntry->lruPrev = cache->lruTail;
+    cacheEntry->lruNext = nullptr;
+
+    if (cache->lruTail != nullptr) {
+        cache->lruTail->lruNext = cacheEntry;
+    } else {
+        cache->lruHead = cacheEntry;
+    }
+
+    cache->lruTail = cacheEntry;
+}
+
+static void cacheLruUnlink(Cache* cache, CacheEntry* cacheEntry)
+{
+    if (cacheEntry->lruPrev != nullptr) {
+        cacheEntry->lruPrev->lruNext = cacheEntry->lruNext;
+    } else {
+        cache->lruHead = cacheEntry->lruNext;
+    }
 
-    if (cmp < 0) {
-        *indexPtr = mid;
+    if (cacheEntry->lruNext != nullptr) {
+        cacheEntry->lruNext->lruPrev = cacheEntry->lruPrev;
     } else {
-        *indexPtr = mid + 1;
+        cache->lruTail = cacheEntry->lruPrev;
     }
 
-    return 3;
+    cacheEntry->lruPrev = nullptr;
+    cacheEntry->lruNext = nullptr;
 }
 
 // 0x420708
@@ -381,6 +438,9 @@ static bool cacheEntryInit(CacheEntry* cacheEntry)
     cacheEntry->hits = 0;
     cacheEntry->flags = 0;
     cacheEntry->mru = 0;
+    cacheEntry->bucketNext = nullptr;
+    cacheEntry->lruPrev = nullptr;
+    cacheEntry->lruNext = nullptr;
     return true;
 }
 
@@ -402,15 +462,16 @@ static bool cacheEntryFree(Cache* cache, CacheEntry* cacheEntry)
 static bool cacheClean(Cache* cache)
 {
     Heap* heap = &(cache->heap);
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = cache->entries[index];
-
-        // NOTE: Original code is slightly different. For unknown reason it uses
-        // inner loop to decrement `referenceCount` one by one. Probably using
-        // some inlined function.
-        if (cacheEntry->referenceCount != 0) {
-            heapUnlock(heap, cacheEntry->heapHandleIndex);
-            cacheEntry->referenceCount = 0;
+    for (int index = 0; index < cache->bucketsLength; index++) {
+        for (CacheEntry* cacheEntry = cache->buckets[index]; cacheEntry != nullptr; cacheEntry = cacheEntry->bucketNext) {
+            // NOTE: Original code is slightly different. For unknown reason it
+            // uses inner loop to decrement `referenceCount` one by one.
+            // Probably using some inlined function.
+            if (cacheEntry->referenceCount != 0) {
+                heapUnlock(heap, cacheEntry->heapHandleIndex);
+                cacheEntry->referenceCount = 0;
+                cacheLruAppend(cache, cacheEntry);
+            }
         }
     }
 
@@ -424,23 +485,23 @@ static bool cacheResetStatistics(Cache* cache)
         return false;
     }
 
-    CacheEntry** entries = (CacheEntry**)internal_malloc(sizeof(*entries) * cache->entriesLength);
-    if (entries == nullptr) {
-        return false;
+    // Eviction order is maintained by the LRU list, `mru` is informational
+    // only. Renumber unreferenced entries in their LRU order and put
+    // referenced ones after them.
+    unsigned int mru = 0;
+    for (CacheEntry* cacheEntry = cache->lruHead; cacheEntry != nullptr; cacheEntry = cacheEntry->lruNext) {
+        cacheEntry->mru = mru++;
     }
 
-    memcpy(entries, cache->entries, sizeof(*entries) * cache->entriesLength);
-
-    qsort(entries, cache->entriesLength, sizeof(*entries), cacheEntriesCompareByMostRecentHit);
-
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = entries[index];
-        cacheEntry->mru = index;
+    for (int index = 0; index < cache->bucketsLength; index++) {
+        for (CacheEntry* cacheEntry = cache->buckets[index]; cacheEntry != nullptr; cacheEntry = cacheEntry->bucketNext) {
+            if (cacheEntry->referenceCount != 0) {
+                cacheEntry->mru = mru++;
+            }
+        }
     }
 
-    cache->hits = cache->entriesLength;
-
-    // FIXME: Obviously leak `entries`.
+    cache->hits = mru;
 
     return true;
 }
@@ -461,57 +522,20 @@ static bool cacheEnsureSize(Cache* cache, int size)
         return true;
     }
 
-    CacheEntry** entries = (CacheEntry**)internal_malloc(sizeof(*entries) * cache->entriesLength);
-    if (entries != nullptr) {
-        memcpy(entries, cache->entries, sizeof(*entries) * cache->entriesLength);
-        qsort(entries, cache->entriesLength, sizeof(*entries), cacheEntriesCompareByUsage);
-
-        // The sweeping threshold is 20% of cache size plus size for the new
-        // entry. Once the threshold is reached the marking process stops.
-        int threshold = size + (int)((double)cache->size * 0.2);
-
-        int accum = 0;
-        int index;
-        for (index = 0; index < cache->entriesLength; index++) {
-            CacheEntry* entry = entries[index];
-            if (entry->referenceCount == 0) {
-                if (entry->size >= threshold) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-
-                    // We've just found one huge entry, there is no point to
-                    // mark individual smaller entries in the code path below,
-                    // reset the accumulator to skip it entirely.
-                    accum = 0;
-                    break;
-                } else {
-                    accum += entry->size;
-
-                    if (accum >= threshold) {
-                        break;
-                    }
-                }
-            }
-        }
+    // The sweeping threshold is 20% of cache size plus size for the new
+    // entry. Evict least recently used entries until the threshold is
+    // reached, so that subsequent misses do not have to evict again right
+    // away.
+    int threshold = size + (int)((double)cache->size * 0.2);
 
-        if (accum != 0) {
-            // The loop below assumes index to be positioned on the entry, where
-            // accumulator stopped. If we've reached the end, reposition
-            // it to the last entry.
-            if (index == cache->entriesLength) {
-                index -= 1;
-            }
+    int accum = 0;
+    for (CacheEntry* cacheEntry = cache->lruHead; cacheEntry != nullptr; cacheEntry = cacheEntry->lruNext) {
+        cacheEntry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
 
-            // Loop backwards from the point we've stopped and mark all
-            // unreferenced entries for sweeping.
-            for (; index >= 0; index--) {
-                CacheEntry* entry = entries[index];
-                if (entry->referenceCount == 0) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-                }
-            }
+        accum += cacheEntry->size;
+        if (accum >= threshold) {
+            break;
         }
-
-        internal_free(entries);
     }
 
     cacheSweep(cache);
@@ -523,97 +547,28 @@ static bool cacheEnsureSize(Cache* cache, int size)
     return false;
 }
 
+// Evicts entries marked for eviction.
+//
+// Only unreferenced entries can be marked and they are always marked starting
+// from the least recently used one, so marked entries form a prefix of the LRU
+// list and the sweep stops at the first unmarked entry.
+//
 // 0x42099C
 static bool cacheSweep(Cache* cache)
 {
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = cache->entries[index];
-        if ((cacheEntry->flags & CACHE_ENTRY_MARKED_FOR_EVICTION) != 0) {
-            if (cacheEntry->referenceCount != 0) {
-                // Entry was marked for eviction but still has references,
-                // unmark it.
-                cacheEntry->flags &= ~CACHE_ENTRY_MARKED_FOR_EVICTION;
-            } else {
-                int cacheEntrySize = cacheEntry->size;
-
-                // NOTE: Uninline.
-                cacheEntryFree(cache, cacheEntry);
-
-                // Move entries up.
-                memmove(&(cache->entries[index]), &(cache->entries[index + 1]), sizeof(*cache->entries) * ((cache->entriesLength - index) - 1));
-
-                cache->entriesLength--;
-                cache->size -= cacheEntrySize;
-
-                // The entry was removed, compensate index.
-                index--;
-            }
+    while (cache->lruHead != nullptr) {
+        CacheEntry* cacheEntry = cache->lruHead;
+        if ((cacheEntry->flags & CACHE_ENTRY_MARKED_FOR_EVICTION) == 0) {
+            break;
         }
-    }
 
-    return true;
-}
+        cacheRemoveEntry(cache, cacheEntry);
 
-// 0x420A40
-static bool cacheSetCapacity(Cache* cache, int newCapacity)
-{
-    if (newCapacity < cache->entriesLength) {
-        return false;
+        // NOTE: Uninline.
+        cacheEntryFree(cache, cacheEntry);
     }
 
-    CacheEntry** entries = (CacheEntry**)internal_realloc(cache->entries, sizeof(*cache->entries) * newCapacity);
-    if (entries == nullptr) {
-        return false;
-    }
-
-    cache->entries = entries;
-    cache->entriesCapacity = newCapacity;
-
     return true;
 }
 
-// 0x420A74
-static int cacheEntriesCompareByUsage(const void* a1, const void* a2)
-{
-    CacheEntry* v1 = *(CacheEntry**)a1;
-    CacheEntry* v2 = *(CacheEntry**)a2;
-
-    if (v1->referenceCount != 0 && v2->referenceCount == 0) {
-        return 1;
-    }
-
-    if (v2->referenceCount != 0 && v1->referenceCount == 0) {
-        return -1;
-    }
-
-    if (v1->hits < v2->hits) {
-        return -1;
-    } else if (v1->hits > v2->hits) {
-        return 1;
-    }
-
-    if (v1->mru < v2->mru) {
-        return -1;
-    } else if (v1->mru > v2->mru) {
-        return 1;
-    }
-
-    return 0;
-}
-
-// 0x420AE8
-static int cacheEntriesCompareByMostRecentHit(const void* a1, const void* a2)
-{
-    CacheEntry* v1 = *(CacheEntry**)a1;
-    CacheEntry* v2 = *(CacheEntry**)a2;
-
-    if (v1->mru < v2->mru) {
-        return 1;
-    } else if (v1->mru > v2->mru) {
-        return -1;
-    } else {
-        return 0;
-    }
-}
-
 } // namespace fallout
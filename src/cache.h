@@ -15,6 +15,11 @@ typedef enum CacheEntryFlags {
     CACHE_ENTRY_MARKED_FOR_EVICTION = 0x01,
 } CacheEntryFlags;
 
+// On cache miss `CacheSizeProc` is called first, and if there is room for the
+// entry, `CacheReadProc` is called for the same key right after it. This allows
+// implementations to keep the source opened by the size proc and finish reading
+// it in the read proc. The read proc is not called when the cache fails to make
+// room for the entry, so such state must be discarded by the next size proc.
 typedef int CacheSizeProc(int key, int* sizePtr);
 typedef int CacheReadProc(int key, int* sizePtr, unsigned char* buffer);
 typedef void CacheFreeProc(void* ptr);
@@ -36,6 +41,15 @@ typedef struct CacheEntry {
     unsigned int mru;
 
     int heapHandleIndex;
+
+    // Next entry in the same hash bucket.
+    struct CacheEntry* bucketNext;
+
+    // Links in the list of unreferenced entries. The list is ordered from
+    // least recently used (head) to most recently used (tail) and is used to
+    // pick eviction candidates in constant time.
+    struct CacheEntry* lruPrev;
+    struct CacheEntry* lruNext;
 } CacheEntry;
 
 typedef struct Cache {
@@ -45,17 +59,21 @@ typedef struct Cache {
     // Maximum size of entries in cache.
     int maxSize;
 
-    // The length of `entries` array.
+    // Number of entries in cache.
     int entriesLength;
 
-    // The capacity of `entries` array.
-    int entriesCapacity;
+    // The length of `buckets` array, always a power of two.
+    int bucketsLength;
 
     // Total number of hits during cache lifetime.
     unsigned int hits;
 
-    // List of cache entries.
-    CacheEntry** entries;
+    // Hash index of cache entries by key.
+    CacheEntry** buckets;
+
+    // Unreferenced entries, least recently used first.
+    CacheEntry* lruHead;
+    CacheEntry* lruTail;
 
     CacheSizeProc* sizeProc;
     CacheReadProc* readProc;
@@ -73,6 +73,12 @@ Color colorMixMulTable[256][256];
 // 0x6A38D0
 unsigned char _colorTable[32768];
 
+// CE: Columns of [intensityColorTable] for every intensity, copied into
+// contiguous rows on first use and dropped when color tables are reloaded.
+// Second set leaves palette animation colors (0xE5 and above) as is.
+static unsigned char gIntensityLuts[2][256][256];
+static bool gIntensityLutsValid[2][256];
+
 // 0x4C72B4
 int _calculateColor(int intensity, Color color)
 {
@@ -359,12 +365,35 @@ bool colorPaletteLoad(const char* path)
 
     _rebuildColorBlendTables();
 
+    // CE: Intensity table has changed.
+    memset(gIntensityLutsValid, 0, sizeof(gIntensityLutsValid));
+
     // NOTE: Uninline.
     fileClose(stream);
 
     return true;
 }
 
+// CE: Returns 256 byte lookup table mapping colors to their shade at given
+// intensity index (intensity / 512), so that blitters touch 256 contiguous
+// bytes instead of a separate row of [intensityColorTable] for every color.
+const unsigned char* colorGetIntensityLut(int intensityIndex, bool keepColorCycled)
+{
+    unsigned char* lut = gIntensityLuts[keepColorCycled][intensityIndex];
+    if (!gIntensityLutsValid[keepColorCycled][intensityIndex]) {
+        for (int color = 0; color < 256; color++) {
+            if (keepColorCycled && color >= 0xE5) {
+                lut[color] = static_cast<unsigned char>(color);
+            } else {
+                lut[color] = intensityColorTable[color][intensityIndex];
+            }
+        }
+        gIntensityLutsValid[keepColorCycled][intensityIndex] = true;
+    }
+
+    return lut;
+}
+
 // 0x4C7AB4
 char* _colorError()
 {
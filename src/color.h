@@ -26,6 +26,7 @@ void _setSystemPalette(unsigned char* palette);
 unsigned char* _getSystemPalette();
 void _setSystemPaletteEntries(unsigned char* a1, int a2, int a3);
 bool colorPaletteLoad(const char* path);
+const unsigned char* colorGetIntensityLut(int intensityIndex, bool keepColorCycled);
 char* _colorError();
 unsigned char* _getColorBlendTable(int ch);
 void _freeColorBlendTable(int a1);
@@ -2388,7 +2388,7 @@ static int _ai_move_steps_closer(Object* critter, Object* target, int actionPoin
     bool shouldUnhide;
     if ((target->flags & OBJECT_MULTIHEX) != 0) {
         shouldUnhide = true;
-        target->flags |= OBJECT_HIDDEN;
+        objectBeginIgnoreBlocking(target);
     } else {
         shouldUnhide = false;
     }
@@ -2399,13 +2399,13 @@ static int _ai_move_steps_closer(Object* critter, Object* target, int actionPoin
             && _moveBlockObj != nullptr
             && PID_TYPE(_moveBlockObj->pid) == OBJ_TYPE_CRITTER) {
             if (shouldUnhide) {
-                target->flags &= ~OBJECT_HIDDEN;
+                objectEndIgnoreBlocking(target);
             }
 
             target = _moveBlockObj;
             if ((target->flags & OBJECT_MULTIHEX) != 0) {
                 shouldUnhide = true;
-                target->flags |= OBJECT_HIDDEN;
+                objectBeginIgnoreBlocking(target);
             } else {
                 shouldUnhide = false;
             }
@@ -2413,7 +2413,7 @@ static int _ai_move_steps_closer(Object* critter, Object* target, int actionPoin
     }
 
     if (shouldUnhide) {
-        target->flags &= ~OBJECT_HIDDEN;
+        objectEndIgnoreBlocking(target);
     }
 
     int tile = target->tile;
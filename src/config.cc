@@ -39,6 +39,9 @@ bool configInit(Config* config)
         return false;
     }
 
+    // Config lookups are far more frequent than insertions.
+    dictionaryEnableHashing(config);
+
     return true;
 }
 
@@ -476,6 +479,8 @@ static bool configEnsureSectionExists(Config* config, const char* sectionKey)
         return false;
     }
 
+    dictionaryEnableHashing(&section);
+
     if (dictionaryAddValue(config, sectionKey, &section) == -1) {
         return false;
     }
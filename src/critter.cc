@@ -881,6 +881,7 @@ void critterKill(Object* critter, int anim, bool a3)
 
     if (!_critter_flag_check(critter->pid, CRITTER_FLAT)) {
         critter->flags |= OBJECT_NO_BLOCK;
+        objectInvalidateBlocking(critter->elevation);
         _obj_toggle_flat(critter, &tempRect);
     }
 
@@ -101,6 +101,16 @@ int dbGetFileContents(const char* filePath, void* ptr)
     assert(filePath); // "filename", "db.c", 141
     assert(ptr); // "buf", "db.c", 142
 
+    if (gFileReadProgressHandler == nullptr) {
+        // Copy straight from memory mapped dbase when possible.
+        size_t size;
+        const unsigned char* data = xbaseGetFileView(filePath, &size);
+        if (data != nullptr) {
+            memcpy(ptr, data, size);
+            return 0;
+        }
+    }
+
     File* stream = xfileOpen(filePath, "rb");
     if (stream == nullptr) {
         return -1;
@@ -136,6 +146,24 @@ int dbGetFileContents(const char* filePath, void* ptr)
     return 0;
 }
 
+// Returns pointer to contents of the specified file, or `nullptr` if the file
+// cannot be accessed without reading (see [xbaseGetFileView]).
+//
+// The contents are read-only and valid until the database is closed.
+const unsigned char* dbGetFileView(const char* filePath, size_t* sizePtr)
+{
+    assert(filePath);
+    assert(sizePtr);
+
+    return xbaseGetFileView(filePath, sizePtr);
+}
+
+// Enables or disables memory mapping of subsequently opened .DAT files.
+void dbSetMemoryMappingEnabled(bool enabled)
+{
+    dbaseSetMemoryMappingEnabled(enabled);
+}
+
 // 0x4C5EB4
 int fileClose(File* stream)
 {
@@ -241,6 +269,14 @@ size_t fileRead(void* ptr, size_t size, size_t count, File* stream)
     return xfileRead(ptr, size, count, stream);
 }
 
+// CE: Same as [fileRead], but without progress accounting. The progress
+// handler is not thread-safe, so this is the only read that can be used from
+// the sound decoder worker thread.
+size_t fileReadRaw(void* ptr, size_t size, size_t count, File* stream)
+{
+    return xfileRead(ptr, size, count, stream);
+}
+
 // 0x4C60B8
 size_t fileWrite(const void* buf, size_t size, size_t count, File* stream)
 {
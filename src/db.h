@@ -16,6 +16,8 @@ int db_total();
 void dbExit();
 int dbGetFileSize(const char* filePath, int* sizePtr);
 int dbGetFileContents(const char* filePath, void* ptr);
+const unsigned char* dbGetFileView(const char* filePath, size_t* sizePtr);
+void dbSetMemoryMappingEnabled(bool enabled);
 int fileClose(File* stream);
 File* fileOpen(const char* filename, const char* mode);
 int filePrintFormatted(File* stream, const char* format, ...);
@@ -23,6 +25,14 @@ int fileReadChar(File* stream);
 char* fileReadString(char* str, size_t size, File* stream);
 int fileWriteString(const char* s, File* stream);
 size_t fileRead(void* buf, size_t size, size_t count, File* stream);
+
+// Thread safety: none of these functions may be called concurrently with each
+// other, with one exception - [fileReadRaw] may be called from another thread
+// (the sound decoder prefetch worker) on a stream that is not used by the main
+// thread at the same time. [fileRead] is not safe there because it calls the
+// read progress handler.
+size_t fileReadRaw(void* buf, size_t size, size_t count, File* stream);
+
 size_t fileWrite(const void* buf, size_t size, size_t count, File* stream);
 int fileSeek(File* stream, long offset, int origin);
 long fileTell(File* stream);
@@ -5,6 +5,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #include <algorithm>
 
 #include <fpattern/fpattern.h>
@@ -38,10 +45,33 @@ namespace fallout {
 #define DFILE_HAS_COMPRESSED_UNGETC (0x10)
 
 static int dbaseFindEntryByFilePath(const void* a1, const void* a2);
-static DFile* dfileOpenInternal(DBase* dbase, const char* filename, const char* mode, DFile* a4);
+static DFile* dfileOpenInternal(DBase* dbase, DBaseEntry* entry, const char* mode, DFile* a4);
 static int dfileReadCharInternal(DFile* stream);
 static bool dfileReadCompressed(DFile* stream, void* ptr, size_t size);
 static void dfileUngetCompressed(DFile* stream, int ch);
+static FILE* dbaseAcquireStream(DBase* dbase);
+static void dbaseReleaseStream(DBase* dbase, FILE* stream);
+static bool dbaseMapFile(DBase* dbase, FILE* stream, long size);
+static void dbaseUnmapFile(DBase* dbase);
+static int dfileInflateInit(DFile* stream);
+
+// Specifies whether .DAT files opened with [dbaseOpen] should be memory mapped.
+static bool gDbaseMemoryMappingEnabled = false;
+
+// Number of currently opened .DAT files which are memory mapped.
+static int gDbaseMappedCount = 0;
+
+// Enables or disables memory mapping of subsequently opened .DAT files.
+void dbaseSetMemoryMappingEnabled(bool enabled)
+{
+    gDbaseMemoryMappingEnabled = enabled;
+}
+
+// Returns `true` if at least one opened .DAT file is memory mapped.
+bool dbaseHasMappedFiles()
+{
+    return gDbaseMappedCount != 0;
+}
 
 // Reads .DAT file contents.
 //
@@ -148,6 +178,11 @@ DBase* dbaseOpen(const char* filePath)
     dbase->path = compat_strdup(filePath);
     dbase->dataOffset = fileSize - dbaseDataSize;
 
+    if (gDbaseMemoryMappingEnabled) {
+        // Failure is not fatal, dbase falls back to reading via streams.
+        dbaseMapFile(dbase, stream, fileSize);
+    }
+
     fclose(stream);
 
     return dbase;
@@ -176,6 +211,12 @@ bool dbaseClose(DBase* dbase)
         curr = next;
     }
 
+    for (int index = 0; index < dbase->streamPoolLength; index++) {
+        fclose(dbase->streamPool[index]);
+    }
+
+    dbaseUnmapFile(dbase);
+
     if (dbase->entries != nullptr) {
         for (int index = 0; index < dbase->entriesLength; index++) {
             DBaseEntry* entry = &(dbase->entries[index]);
@@ -235,6 +276,28 @@ bool dbaseFindClose(DBase* dbase, DFileFindData* findFileData)
     return true;
 }
 
+// Obtains contents of the [entry] of [dbase] without copying.
+//
+// Returns `false` if the entry cannot be viewed directly (dbase is not memory
+// mapped, or the entry is compressed). Otherwise returns `true` and sets
+// [dataPtr] to the entry contents, which are valid until [dbase] is closed.
+bool dbaseGetEntryView(DBase* dbase, DBaseEntry* entry, const unsigned char** dataPtr, size_t* sizePtr)
+{
+    if (dbase->mappedData == nullptr || entry->compressed == 1) {
+        return false;
+    }
+
+    size_t offset = (size_t)dbase->dataOffset + entry->dataOffset;
+    if (offset + entry->uncompressedSize > dbase->mappedSize) {
+        return false;
+    }
+
+    *dataPtr = dbase->mappedData + offset;
+    *sizePtr = entry->uncompressedSize;
+
+    return true;
+}
+
 // [filelength].
 //
 // 0x4E5424
@@ -267,7 +330,7 @@ int dfileClose(DFile* stream)
     }
 
     if (stream->stream != nullptr) {
-        fclose(stream->stream);
+        dbaseReleaseStream(stream->dbase, stream->stream);
     }
 
     // Loop thru open file handles and find previous to remove current handle
@@ -309,7 +372,23 @@ DFile* dfileOpen(DBase* dbase, const char* filePath, const char* mode)
     assert(filePath); // dfile.c, 296
     assert(mode); // dfile.c, 297
 
-    return dfileOpenInternal(dbase, filePath, mode, nullptr);
+    DBaseEntry* entry = (DBaseEntry*)bsearch(filePath, dbase->entries, dbase->entriesLength, sizeof(*dbase->entries), dbaseFindEntryByFilePath);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+
+    return dfileOpenInternal(dbase, entry, mode, nullptr);
+}
+
+// Same as [dfileOpen], but opens [entry] which is already known to belong to
+// [dbase], avoiding lookup.
+DFile* dfileOpenEntry(DBase* dbase, DBaseEntry* entry, const char* mode)
+{
+    assert(dbase);
+    assert(entry);
+    assert(mode);
+
+    return dfileOpenInternal(dbase, entry, mode, nullptr);
 }
 
 // [vfprintf].
@@ -463,6 +542,10 @@ size_t dfileRead(void* ptr, size_t size, size_t count, DFile* stream)
         }
 
         bytesRead = bytesToRead;
+    } else if (stream->dbase->mappedData != nullptr) {
+        memcpy(ptr, stream->dbase->mappedData + stream->dbase->dataOffset + stream->entry->dataOffset + stream->position, bytesToRead);
+        stream->position += bytesToRead;
+        bytesRead = bytesToRead + extraBytesRead;
     } else {
         bytesRead = fread(ptr, 1, bytesToRead, stream->stream) + extraBytesRead;
         stream->position += bytesRead;
@@ -542,6 +625,8 @@ int dfileSeek(DFile* stream, long offset, int origin)
                     return 1;
                 }
             }
+        } else if (stream->dbase->mappedData != nullptr) {
+            stream->position = offsetFromBeginning;
         } else {
             if (fseek(stream->stream, offsetFromBeginning - pos, SEEK_CUR) != 0) {
                 stream->flags |= DFILE_ERROR;
@@ -557,6 +642,25 @@ int dfileSeek(DFile* stream, long offset, int origin)
         return 0;
     }
 
+    if (stream->dbase->mappedData != nullptr) {
+        if (stream->entry->compressed == 1) {
+            if (inflateEnd(stream->decompressionStream) != Z_OK) {
+                stream->flags |= DFILE_ERROR;
+                return 1;
+            }
+
+            if (dfileInflateInit(stream) != Z_OK) {
+                stream->flags |= DFILE_ERROR;
+                return 1;
+            }
+        }
+
+        stream->position = 0;
+        stream->flags &= ~(DFILE_HAS_UNGETC | DFILE_EOF);
+
+        return 0;
+    }
+
     if (fseek(stream->stream, stream->dbase->dataOffset + stream->entry->dataOffset, SEEK_SET) != 0) {
         stream->flags |= DFILE_ERROR;
         return 1;
@@ -567,19 +671,14 @@ int dfileSeek(DFile* stream, long offset, int origin)
         return 1;
     }
 
-    stream->decompressionStream->zalloc = Z_NULL;
-    stream->decompressionStream->zfree = Z_NULL;
-    stream->decompressionStream->opaque = Z_NULL;
-    stream->decompressionStream->next_in = stream->decompressionBuffer;
-    stream->decompressionStream->avail_in = 0;
+    stream->compressedBytesRead = 0;
 
-    if (inflateInit(stream->decompressionStream) != Z_OK) {
+    if (dfileInflateInit(stream) != Z_OK) {
         stream->flags |= DFILE_ERROR;
         return 1;
     }
 
     stream->position = 0;
-    stream->compressedBytesRead = 0;
     stream->flags &= ~(DFILE_HAS_UNGETC | DFILE_EOF);
 
     return 0;
@@ -629,14 +728,13 @@ static int dbaseFindEntryByFilePath(const void* a1, const void* a2)
     return compat_stricmp(filePath, entry->path);
 }
 
+// NOTE: Original code accepts file path and looks up entry itself. The lookup
+// is moved to callers so that entries found via xbase index can be opened
+// directly.
+//
 // 0x4E5D9C
-static DFile* dfileOpenInternal(DBase* dbase, const char* filePath, const char* mode, DFile* dfile)
+static DFile* dfileOpenInternal(DBase* dbase, DBaseEntry* entry, const char* mode, DFile* dfile)
 {
-    DBaseEntry* entry = (DBaseEntry*)bsearch(filePath, dbase->entries, dbase->entriesLength, sizeof(*dbase->entries), dbaseFindEntryByFilePath);
-    if (entry == nullptr) {
-        goto err;
-    }
-
     if (mode[0] != 'r') {
         goto err;
     }
@@ -657,7 +755,7 @@ static DFile* dfileOpenInternal(DBase* dbase, const char* filePath, const char*
         }
 
         if (dfile->stream != nullptr) {
-            fclose(dfile->stream);
+            dbaseReleaseStream(dbase, dfile->stream);
             dfile->stream = nullptr;
         }
 
@@ -668,15 +766,24 @@ static DFile* dfileOpenInternal(DBase* dbase, const char* filePath, const char*
 
     dfile->entry = entry;
 
-    // Open stream to .DAT file.
-    dfile->stream = compat_fopen(dbase->path, "rb");
-    if (dfile->stream == nullptr) {
-        goto err;
-    }
+    if (dbase->mappedData != nullptr) {
+        // Make sure entry data is within the mapping, so that reads do not
+        // need to check it.
+        size_t dataSize = entry->compressed == 1 ? entry->dataSize : entry->uncompressedSize;
+        if ((size_t)dbase->dataOffset + entry->dataOffset + dataSize > dbase->mappedSize) {
+            goto err;
+        }
+    } else {
+        // Open stream to .DAT file (or reuse one of the idle streams).
+        dfile->stream = dbaseAcquireStream(dbase);
+        if (dfile->stream == nullptr) {
+            goto err;
+        }
 
-    // Relocate stream to the beginning of data for specified entry.
-    if (fseek(dfile->stream, dbase->dataOffset + entry->dataOffset, SEEK_SET) != 0) {
-        goto err;
+        // Relocate stream to the beginning of data for specified entry.
+        if (fseek(dfile->stream, dbase->dataOffset + entry->dataOffset, SEEK_SET) != 0) {
+            goto err;
+        }
     }
 
     if (entry->compressed == 1) {
@@ -690,19 +797,16 @@ static DFile* dfileOpenInternal(DBase* dbase, const char* filePath, const char*
                 goto err;
             }
 
-            dfile->decompressionBuffer = (unsigned char*)malloc(DFILE_DECOMPRESSION_BUFFER_SIZE);
-            if (dfile->decompressionBuffer == nullptr) {
-                goto err;
+            // Memory mapped dbase inflates straight from the mapping.
+            if (dbase->mappedData == nullptr) {
+                dfile->decompressionBuffer = (unsigned char*)malloc(DFILE_DECOMPRESSION_BUFFER_SIZE);
+                if (dfile->decompressionBuffer == nullptr) {
+                    goto err;
+                }
             }
         }
 
-        dfile->decompressionStream->zalloc = Z_NULL;
-        dfile->decompressionStream->zfree = Z_NULL;
-        dfile->decompressionStream->opaque = Z_NULL;
-        dfile->decompressionStream->next_in = dfile->decompressionBuffer;
-        dfile->decompressionStream->avail_in = 0;
-
-        if (inflateInit(dfile->decompressionStream) != Z_OK) {
+        if (dfileInflateInit(dfile) != Z_OK) {
             goto err;
         }
     } else {
@@ -768,6 +872,23 @@ static int dfileReadCharInternal(DFile* stream)
         return -1;
     }
 
+    if (stream->dbase->mappedData != nullptr) {
+        const unsigned char* data = stream->dbase->mappedData + stream->dbase->dataOffset + stream->entry->dataOffset;
+
+        int ch = data[stream->position++];
+        if ((stream->flags & DFILE_TEXT) != 0) {
+            // This is a text stream, attempt to detect \r\n sequence.
+            if (ch == '\r') {
+                if (stream->position < stream->entry->uncompressedSize && data[stream->position] == '\n') {
+                    ch = '\n';
+                    stream->position++;
+                }
+            }
+        }
+
+        return ch;
+    }
+
     int ch = fgetc(stream->stream);
     if (ch != -1) {
         if ((stream->flags & DFILE_TEXT) != 0) {
@@ -819,6 +940,12 @@ static bool dfileReadCompressed(DFile* stream, void* ptr, size_t size)
         }
 
         if (stream->decompressionStream->avail_in == 0) {
+            if (stream->dbase->mappedData != nullptr) {
+                // Entire compressed data was provided upfront, there is
+                // nothing more to feed.
+                break;
+            }
+
             // No more unprocessed data, request next chunk.
             size_t bytesToRead = std::min(DFILE_DECOMPRESSION_BUFFER_SIZE, stream->entry->dataSize - stream->compressedBytesRead);
 
@@ -854,4 +981,107 @@ static void dfileUngetCompressed(DFile* stream, int ch)
     stream->position--;
 }
 
+// Returns idle stream from [dbase] stream pool, or opens a new one if the
+// pool is empty. The returned stream must be repositioned by the caller.
+static FILE* dbaseAcquireStream(DBase* dbase)
+{
+    if (dbase->streamPoolLength > 0) {
+        dbase->streamPoolLength--;
+        return dbase->streamPool[dbase->streamPoolLength];
+    }
+
+    return compat_fopen(dbase->path, "rb");
+}
+
+// Returns stream to [dbase] stream pool, or closes it if the pool is full or
+// the stream is in error state.
+static void dbaseReleaseStream(DBase* dbase, FILE* stream)
+{
+    if (dbase->streamPoolLength < DBASE_STREAM_POOL_CAPACITY && ferror(stream) == 0) {
+        dbase->streamPool[dbase->streamPoolLength] = stream;
+        dbase->streamPoolLength++;
+        return;
+    }
+
+    fclose(stream);
+}
+
+// Prepares decompression stream of [stream] to inflate entry data from the
+// beginning.
+static int dfileInflateInit(DFile* stream)
+{
+    stream->decompressionStream->zalloc = Z_NULL;
+    stream->decompressionStream->zfree = Z_NULL;
+    stream->decompressionStream->opaque = Z_NULL;
+
+    if (stream->dbase->mappedData != nullptr) {
+        stream->decompressionStream->next_in = stream->dbase->mappedData + stream->dbase->dataOffset + stream->entry->dataOffset;
+        stream->decompressionStream->avail_in = stream->entry->dataSize;
+        stream->compressedBytesRead = stream->entry->dataSize;
+    } else {
+        stream->decompressionStream->next_in = stream->decompressionBuffer;
+        stream->decompressionStream->avail_in = 0;
+    }
+
+    return inflateInit(stream->decompressionStream);
+}
+
+// Maps entire .DAT file into memory for reading.
+static bool dbaseMapFile(DBase* dbase, FILE* stream, long size)
+{
+    if (size <= 0) {
+        return false;
+    }
+
+#ifdef _WIN32
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(stream));
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    // The view keeps mapping object alive, there is no need to keep handle.
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data == nullptr) {
+        return false;
+    }
+#else
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(stream), 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+#endif
+
+    dbase->mappedData = (unsigned char*)data;
+    dbase->mappedSize = size;
+
+    gDbaseMappedCount++;
+
+    return true;
+}
+
+static void dbaseUnmapFile(DBase* dbase)
+{
+    if (dbase->mappedData == nullptr) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(dbase->mappedData);
+#else
+    munmap(dbase->mappedData, dbase->mappedSize);
+#endif
+
+    dbase->mappedData = nullptr;
+    dbase->mappedSize = 0;
+
+    gDbaseMappedCount--;
+}
+
 } // namespace fallout
@@ -9,6 +9,9 @@
 
 namespace fallout {
 
+// The maximum number of idle .DAT streams kept open by [DBase] for reuse.
+#define DBASE_STREAM_POOL_CAPACITY (8)
+
 typedef struct DBase DBase;
 typedef struct DBaseEntry DBaseEntry;
 typedef struct DFile DFile;
@@ -29,6 +32,29 @@ typedef struct DBase {
 
     // The head of linked list of open file handles.
     DFile* dfileHead;
+
+    // Streams of .DAT file released by closed [DFile]s.
+    //
+    // Opening .DAT file for every entry is expensive (path resolution and
+    // `open` syscall), so instead of closing the stream [dfileClose] puts it
+    // here, and [dfileOpen] takes it back, repositioning it to the data of
+    // the new entry.
+    FILE* streamPool[DBASE_STREAM_POOL_CAPACITY];
+
+    // The number of streams in `streamPool`.
+    int streamPoolLength;
+
+    // The contents of .DAT file mapped into memory.
+    //
+    // This value is NULL unless memory mapping was enabled with
+    // [dbaseSetMemoryMappingEnabled] when this dbase was opened. When set,
+    // [DFile]s do not use streams (and `streamPool`) at all, uncompressed
+    // entries are copied straight from the mapping, and compressed entries
+    // are inflated directly from it.
+    unsigned char* mappedData;
+
+    // The size of `mappedData`.
+    size_t mappedSize;
 } DBase;
 
 typedef struct DBaseEntry {
@@ -47,8 +73,9 @@ typedef struct DFile {
 
     // The stream of .DAT file opened for reading in binary mode.
     //
-    // This stream is not shared across open handles. Instead every [DFile]
-    // opens it's own stream via [fopen], which is then closed via [fclose] in
+    // This stream is not shared across open handles, every [DFile] owns it's
+    // own stream. The stream is taken from [DBase] stream pool (or opened via
+    // [fopen] when the pool is empty), and returned to the pool in
     // [dfileClose].
     FILE* stream;
 
@@ -59,7 +86,8 @@ typedef struct DFile {
 
     // The decompression buffer of size [DFILE_DECOMPRESSION_BUFFER_SIZE].
     //
-    // This value is NULL if entry is not compressed.
+    // This value is NULL if entry is not compressed, or [DBase] is memory
+    // mapped.
     unsigned char* decompressionBuffer;
 
     // The last ungot character.
@@ -110,14 +138,18 @@ typedef struct DFileFindData {
     int index;
 } DFileFindData;
 
+void dbaseSetMemoryMappingEnabled(bool enabled);
+bool dbaseHasMappedFiles();
 DBase* dbaseOpen(const char* filename);
 bool dbaseClose(DBase* dbase);
 bool dbaseFindFirstEntry(DBase* dbase, DFileFindData* findFileData, const char* pattern);
 bool dbaseFindNextEntry(DBase* dbase, DFileFindData* findFileData);
 bool dbaseFindClose(DBase* dbase, DFileFindData* findFileData);
+bool dbaseGetEntryView(DBase* dbase, DBaseEntry* entry, const unsigned char** dataPtr, size_t* sizePtr);
 long dfileGetSize(DFile* stream);
 int dfileClose(DFile* stream);
 DFile* dfileOpen(DBase* dbase, const char* filename, const char* mode);
+DFile* dfileOpenEntry(DBase* dbase, DBaseEntry* entry, const char* mode);
 int dfilePrintFormattedArgs(DFile* stream, const char* format, va_list args);
 int dfileReadChar(DFile* stream);
 char* dfileReadString(char* str, int size, DFile* stream);
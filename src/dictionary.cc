@@ -14,7 +14,17 @@ namespace fallout {
 // with a check for this value.
 #define DICTIONARY_MARKER 0xFEBAFEBA
 
+// The minimum number of buckets in dictionary hash index.
+#define DICTIONARY_HASH_MIN_CAPACITY 16
+
 static int dictionaryFindIndexForKey(Dictionary* dictionary, const char* key, int* index);
+static unsigned int dictionaryHashKey(const char* key);
+static int dictionaryHashFind(Dictionary* dictionary, const char* key, int* bucketPtr);
+static void dictionaryHashInsert(Dictionary* dictionary, int index);
+static void dictionaryHashRemove(Dictionary* dictionary, int bucket);
+static void dictionaryHashRebuild(Dictionary* dictionary);
+static void dictionaryHashFree(Dictionary* dictionary);
+static int dictionaryEntryCompare(const void* a1, const void* a2);
 
 // 0x4D9BA8
 int dictionaryInit(Dictionary* dictionary, int initialCapacity, size_t valueSize, DictionaryIO* io)
@@ -22,6 +32,8 @@ int dictionaryInit(Dictionary* dictionary, int initialCapacity, size_t valueSize
     dictionary->entriesCapacity = initialCapacity;
     dictionary->valueSize = valueSize;
     dictionary->entriesLength = 0;
+    dictionary->hashBuckets = nullptr;
+    dictionary->hashBucketsLength = 0;
 
     if (io != nullptr) {
         memcpy(&(dictionary->io), io, sizeof(*io));
@@ -94,6 +106,8 @@ int dictionaryFree(Dictionary* dictionary)
         internal_free(dictionary->entries);
     }
 
+    dictionaryHashFree(dictionary);
+
     memset(dictionary, 0, sizeof(*dictionary));
 
     return 0;
@@ -118,33 +132,25 @@ static int dictionaryFindIndexForKey(Dictionary* dictionary, const char* key, in
 
     int r = dictionary->entriesLength - 1;
     int l = 0;
-    int mid = 0;
-    int cmp = 0;
     while (r >= l) {
-        mid = (l + r) / 2;
+        int mid = l + (r - l) / 2;
 
-        cmp = compat_stricmp(key, dictionary->entries[mid].key);
+        int cmp = compat_stricmp(key, dictionary->entries[mid].key);
         if (cmp == 0) {
-            break;
+            *indexPtr = mid;
+            return 0;
         }
 
         if (cmp > 0) {
-            l = l + 1;
+            l = mid + 1;
         } else {
-            r = r - 1;
+            r = mid - 1;
         }
     }
 
-    if (cmp == 0) {
-        *indexPtr = mid;
-        return 0;
-    }
-
-    if (cmp < 0) {
-        *indexPtr = mid;
-    } else {
-        *indexPtr = mid + 1;
-    }
+    // When the loop is over [l] points to the first entry which is greater
+    // than the key, which is exactly the insertion point.
+    *indexPtr = l;
 
     return -1;
 }
@@ -159,6 +165,11 @@ int dictionaryGetIndexByKey(Dictionary* dictionary, const char* key)
         return -1;
     }
 
+    if (dictionary->hashBuckets != nullptr) {
+        int bucket;
+        return dictionaryHashFind(dictionary, key, &bucket);
+    }
+
     int index;
     if (dictionaryFindIndexForKey(dictionary, key, &index) != 0) {
         return -1;
@@ -215,13 +226,10 @@ int dictionaryAddValue(Dictionary* dictionary, const char* key, const void* valu
         memcpy(valueCopy, value, dictionary->valueSize);
     }
 
-    // Starting at the end of entries array loop backwards and move entries down
-    // one by one until we reach insertion point.
-    for (int index = dictionary->entriesLength; index > newElementIndex; index--) {
-        DictionaryEntry* src = &(dictionary->entries[index - 1]);
-        DictionaryEntry* dest = &(dictionary->entries[index]);
-        memcpy(dest, src, sizeof(*dictionary->entries));
-    }
+    // Move entries past insertion point down to make room for the new one.
+    memmove(&(dictionary->entries[newElementIndex + 1]),
+        &(dictionary->entries[newElementIndex]),
+        sizeof(*dictionary->entries) * (dictionary->entriesLength - newElementIndex));
 
     DictionaryEntry* entry = &(dictionary->entries[newElementIndex]);
     entry->key = keyCopy;
@@ -229,6 +237,22 @@ int dictionaryAddValue(Dictionary* dictionary, const char* key, const void* valu
 
     dictionary->entriesLength++;
 
+    if (dictionary->hashBuckets != nullptr) {
+        if (dictionary->entriesLength * 2 > dictionary->hashBucketsLength) {
+            dictionaryHashRebuild(dictionary);
+        } else {
+            // Entries past insertion point were moved down, adjust their
+            // indexes accordingly.
+            for (int bucket = 0; bucket < dictionary->hashBucketsLength; bucket++) {
+                if (dictionary->hashBuckets[bucket] > newElementIndex) {
+                    dictionary->hashBuckets[bucket]++;
+                }
+            }
+
+            dictionaryHashInsert(dictionary, newElementIndex);
+        }
+    }
+
     return 0;
 }
 
@@ -245,8 +269,19 @@ int dictionaryRemoveValue(Dictionary* dictionary, const char* key)
     }
 
     int indexToRemove;
-    if (dictionaryFindIndexForKey(dictionary, key, &indexToRemove) == -1) {
-        return -1;
+    if (dictionary->hashBuckets != nullptr) {
+        int bucket;
+        indexToRemove = dictionaryHashFind(dictionary, key, &bucket);
+        if (indexToRemove == -1) {
+            return -1;
+        }
+
+        // Should be done while entry key is still valid.
+        dictionaryHashRemove(dictionary, bucket);
+    } else {
+        if (dictionaryFindIndexForKey(dictionary, key, &indexToRemove) == -1) {
+            return -1;
+        }
     }
 
     DictionaryEntry* entry = &(dictionary->entries[indexToRemove]);
@@ -259,12 +294,17 @@ int dictionaryRemoveValue(Dictionary* dictionary, const char* key)
 
     dictionary->entriesLength--;
 
-    // Starting from the index of the entry we've just removed, loop thru the
-    // remaining of the array and move entries up one by one.
-    for (int index = indexToRemove; index < dictionary->entriesLength; index++) {
-        DictionaryEntry* src = &(dictionary->entries[index + 1]);
-        DictionaryEntry* dest = &(dictionary->entries[index]);
-        memcpy(dest, src, sizeof(*dictionary->entries));
+    // Move remaining entries up to fill the gap.
+    memmove(&(dictionary->entries[indexToRemove]),
+        &(dictionary->entries[indexToRemove + 1]),
+        sizeof(*dictionary->entries) * (dictionary->entriesLength - indexToRemove));
+
+    if (dictionary->hashBuckets != nullptr) {
+        for (int bucket = 0; bucket < dictionary->hashBucketsLength; bucket++) {
+            if (dictionary->hashBuckets[bucket] > indexToRemove + 1) {
+                dictionary->hashBuckets[bucket]--;
+            }
+        }
     }
 
     return 0;
@@ -284,6 +324,10 @@ int dictionaryCopy(Dictionary* dest, Dictionary* src)
         return 0;
     }
 
+    if (src->hashBuckets != nullptr) {
+        dictionaryEnableHashing(dest);
+    }
+
     for (int index = 0; index < src->entriesLength; index++) {
         DictionaryEntry* entry = &(src->entries[index]);
         if (dictionaryAddValue(dest, entry->key, entry->value) == -1) {
@@ -381,6 +425,10 @@ int dictionaryLoad(FILE* stream, Dictionary* dictionary, int a3)
         internal_free(dictionary->entries);
     }
 
+    // Hash index is rebuilt at once when all entries are loaded.
+    bool hashed = dictionary->hashBuckets != nullptr;
+    dictionaryHashFree(dictionary);
+
     if (dictionaryReadHeader(stream, dictionary) != 0) {
         return -1;
     }
@@ -440,6 +488,14 @@ int dictionaryLoad(FILE* stream, Dictionary* dictionary, int a3)
         }
     }
 
+    // Entries are read in bulk without any assumptions on their order, so
+    // sort them once instead of inserting one by one.
+    qsort(dictionary->entries, dictionary->entriesLength, sizeof(*dictionary->entries), dictionaryEntryCompare);
+
+    if (hashed) {
+        dictionaryEnableHashing(dictionary);
+    }
+
     return 0;
 }
 
@@ -512,4 +568,135 @@ int dictionaryWrite(FILE* stream, Dictionary* dictionary, int a3)
     return 0;
 }
 
+// Enables hash index for the dictionary.
+//
+// Once enabled the index is maintained by all dictionary operations. Failure
+// to allocate hash index is not fatal, in this case dictionary falls back to
+// binary search.
+int dictionaryEnableHashing(Dictionary* dictionary)
+{
+    if (dictionary->marker != DICTIONARY_MARKER) {
+        return -1;
+    }
+
+    dictionaryHashRebuild(dictionary);
+
+    return dictionary->hashBuckets != nullptr ? 0 : -1;
+}
+
+// Computes FNV-1a hash of the key folded to lower case, consistent with
+// [compat_stricmp] used to compare keys.
+static unsigned int dictionaryHashKey(const char* key)
+{
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* ch = (const unsigned char*)key; *ch != '\0'; ch++) {
+        unsigned char lower = *ch >= 'A' && *ch <= 'Z' ? *ch + ('a' - 'A') : *ch;
+        hash ^= lower;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Returns index of the entry for the specified key using hash index, or -1
+// if it's not present in the dictionary. [bucketPtr] is set to the bucket
+// holding the entry.
+static int dictionaryHashFind(Dictionary* dictionary, const char* key, int* bucketPtr)
+{
+    int mask = dictionary->hashBucketsLength - 1;
+    int bucket = dictionaryHashKey(key) & mask;
+    while (dictionary->hashBuckets[bucket] != 0) {
+        int index = dictionary->hashBuckets[bucket] - 1;
+        if (compat_stricmp(key, dictionary->entries[index].key) == 0) {
+            *bucketPtr = bucket;
+            return index;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+
+    return -1;
+}
+
+// Adds entry at the specified index to hash index. The caller is responsible
+// for keeping hash index at most half full.
+static void dictionaryHashInsert(Dictionary* dictionary, int index)
+{
+    int mask = dictionary->hashBucketsLength - 1;
+    int bucket = dictionaryHashKey(dictionary->entries[index].key) & mask;
+    while (dictionary->hashBuckets[bucket] != 0) {
+        bucket = (bucket + 1) & mask;
+    }
+
+    dictionary->hashBuckets[bucket] = index + 1;
+}
+
+// Clears the specified bucket and moves subsequent entries of the probe
+// sequence back so that lookups do not stop at the gap.
+static void dictionaryHashRemove(Dictionary* dictionary, int bucket)
+{
+    int mask = dictionary->hashBucketsLength - 1;
+    int gap = bucket;
+    int next = bucket;
+    while (true) {
+        next = (next + 1) & mask;
+        if (dictionary->hashBuckets[next] == 0) {
+            break;
+        }
+
+        int index = dictionary->hashBuckets[next] - 1;
+        int home = dictionaryHashKey(dictionary->entries[index].key) & mask;
+
+        // Entry can be moved to the gap only if its home bucket is not
+        // (cyclically) between the gap and its current bucket.
+        if (((next - home) & mask) >= ((next - gap) & mask)) {
+            dictionary->hashBuckets[gap] = dictionary->hashBuckets[next];
+            gap = next;
+        }
+    }
+
+    dictionary->hashBuckets[gap] = 0;
+}
+
+// Resizes hash index to fit dictionary entries and reinserts them all.
+static void dictionaryHashRebuild(Dictionary* dictionary)
+{
+    int capacity = DICTIONARY_HASH_MIN_CAPACITY;
+    while (capacity < dictionary->entriesLength * 2) {
+        capacity *= 2;
+    }
+
+    if (capacity != dictionary->hashBucketsLength) {
+        int* buckets = (int*)internal_realloc(dictionary->hashBuckets, sizeof(*buckets) * capacity);
+        if (buckets == nullptr) {
+            dictionaryHashFree(dictionary);
+            return;
+        }
+
+        dictionary->hashBuckets = buckets;
+        dictionary->hashBucketsLength = capacity;
+    }
+
+    memset(dictionary->hashBuckets, 0, sizeof(*dictionary->hashBuckets) * dictionary->hashBucketsLength);
+
+    for (int index = 0; index < dictionary->entriesLength; index++) {
+        dictionaryHashInsert(dictionary, index);
+    }
+}
+
+static void dictionaryHashFree(Dictionary* dictionary)
+{
+    if (dictionary->hashBuckets != nullptr) {
+        internal_free(dictionary->hashBuckets);
+        dictionary->hashBuckets = nullptr;
+    }
+
+    dictionary->hashBucketsLength = 0;
+}
+
+static int dictionaryEntryCompare(const void* a1, const void* a2)
+{
+    const DictionaryEntry* v1 = (const DictionaryEntry*)a1;
+    const DictionaryEntry* v2 = (const DictionaryEntry*)a2;
+    return compat_stricmp(v1->key, v2->key);
+}
+
 } // namespace fallout
@@ -29,6 +29,10 @@ typedef struct DictionaryEntry {
 // are kept sorted by the key. Both keys and values are copied when new entry
 // is added to dictionary. For this reason the size of the value's type is
 // provided during dictionary initialization.
+//
+// Dictionary can optionally maintain a hash index on top of the sorted array
+// (see [dictionaryEnableHashing]). It speeds up lookups of existing keys,
+// while insertion point lookups still use binary search.
 typedef struct Dictionary {
     int marker;
 
@@ -46,11 +50,20 @@ typedef struct Dictionary {
 
     // The array of key-value pairs.
     DictionaryEntry* entries;
+
+    // Open-addressed hash index of [entries] by case-insensitive key, or
+    // `nullptr` when hashing is not enabled. Each bucket holds entry index
+    // plus one, zero denotes empty bucket.
+    int* hashBuckets;
+
+    // The number of buckets in [hashBuckets], always a power of two.
+    int hashBucketsLength;
 } Dictionary;
 
 int dictionaryInit(Dictionary* dictionary, int initialCapacity, size_t valueSize, DictionaryIO* io);
 int dictionarySetCapacity(Dictionary* dictionary, int newCapacity);
 int dictionaryFree(Dictionary* dictionary);
+int dictionaryEnableHashing(Dictionary* dictionary);
 int dictionaryGetIndexByKey(Dictionary* dictionary, const char* key);
 int dictionaryAddValue(Dictionary* dictionary, const char* key, const void* value);
 int dictionaryRemoveValue(Dictionary* dictionary, const char* key);
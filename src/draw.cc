@@ -1,7 +1,10 @@
 #include "draw.h"
 
+#include <stdint.h>
 #include <string.h>
 
+#include <vector>
+
 #include "color.h"
 #include "svga.h"
 
@@ -148,29 +151,54 @@ void bufferDrawRectShadowed(unsigned char* buf, int pitch, int left, int top, in
     bufferDrawLine(buf, pitch, right, top, right, bottom, rbColor);
 }
 
+// CE: Builds table of source columns for every destination column covered by
+// stretched blit and returns number of such columns.
+//
+// In the original code every source pixel is expanded into a block of
+// destination pixels. These blocks are adjacent and start at zero, so every
+// covered destination column (and row) is taken from exactly one source
+// column (and row).
+static int _stretch_columns_init(std::vector<int>& columns, int srcWidth, int stepX)
+{
+    int destLimit = (srcWidth * stepX) >> 16;
+    columns.resize(destLimit);
+
+    for (int srcX = 0; srcX < srcWidth; srcX += 1) {
+        int startDestX = (srcX * stepX) >> 16;
+        int endDestX = ((srcX + 1) * stepX) >> 16;
+        for (int destX = startDestX; destX < endDestX; destX += 1) {
+            columns[destX] = srcX;
+        }
+    }
+
+    return destLimit;
+}
+
 // 0x4D33F0
 void blitBufferToBufferStretch(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destWidth, int destHeight, int destPitch)
 {
     int stepX = (destWidth << 16) / srcWidth;
     int stepY = (destHeight << 16) / srcHeight;
 
+    static std::vector<int> columns;
+    int destLimitX = _stretch_columns_init(columns, srcWidth, stepX);
+
     for (int srcY = 0; srcY < srcHeight; srcY += 1) {
         int startDestY = (srcY * stepY) >> 16;
         int endDestY = ((srcY + 1) * stepY) >> 16;
+        if (startDestY >= endDestY) {
+            continue;
+        }
 
         unsigned char* currSrc = src + srcPitch * srcY;
-        for (int srcX = 0; srcX < srcWidth; srcX += 1) {
-            int startDestX = (srcX * stepX) >> 16;
-            int endDestX = ((srcX + 1) * stepX) >> 16;
-
-            for (int destY = startDestY; destY < endDestY; destY += 1) {
-                unsigned char* currDest = dest + destPitch * destY + startDestX;
-                for (int destX = startDestX; destX < endDestX; destX += 1) {
-                    *currDest++ = *currSrc;
-                }
-            }
+        unsigned char* firstDest = dest + destPitch * startDestY;
+        for (int destX = 0; destX < destLimitX; destX += 1) {
+            firstDest[destX] = currSrc[columns[destX]];
+        }
 
-            currSrc++;
+        // Remaining rows of the block are the same.
+        for (int destY = startDestY + 1; destY < endDestY; destY += 1) {
+            memcpy(dest + destPitch * destY, firstDest, destLimitX);
         }
     }
 }
@@ -181,25 +209,22 @@ void blitBufferToBufferStretchTrans(unsigned char* src, int srcWidth, int srcHei
     int stepX = (destWidth << 16) / srcWidth;
     int stepY = (destHeight << 16) / srcHeight;
 
+    static std::vector<int> columns;
+    int destLimitX = _stretch_columns_init(columns, srcWidth, stepX);
+
     for (int srcY = 0; srcY < srcHeight; srcY += 1) {
         int startDestY = (srcY * stepY) >> 16;
         int endDestY = ((srcY + 1) * stepY) >> 16;
 
         unsigned char* currSrc = src + srcPitch * srcY;
-        for (int srcX = 0; srcX < srcWidth; srcX += 1) {
-            int startDestX = (srcX * stepX) >> 16;
-            int endDestX = ((srcX + 1) * stepX) >> 16;
-
-            if (*currSrc != 0) {
-                for (int destY = startDestY; destY < endDestY; destY += 1) {
-                    unsigned char* currDest = dest + destPitch * destY + startDestX;
-                    for (int destX = startDestX; destX < endDestX; destX += 1) {
-                        *currDest++ = *currSrc;
-                    }
+        for (int destY = startDestY; destY < endDestY; destY += 1) {
+            unsigned char* currDest = dest + destPitch * destY;
+            for (int destX = 0; destX < destLimitX; destX += 1) {
+                unsigned char color = currSrc[columns[destX]];
+                if (color != 0) {
+                    currDest[destX] = color;
                 }
             }
-
-            currSrc++;
         }
     }
 }
@@ -323,19 +348,47 @@ void srcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitc
 // 0x4E0ED5
 void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height)
 {
-    int destSkip = destPitch - width;
-    int srcSkip = srcPitch - width;
+    const uint64_t kLow7Bits = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t kHighBits = 0x8080808080808080ULL;
 
     for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            unsigned char c = *src++;
+        int x = 0;
+
+        // CE: Process 8 pixels at once. Fully transparent and fully opaque
+        // spans (which are most of the interface art) take a single load and
+        // store, mixed spans are merged with a per-byte mask.
+        for (; x + 8 <= width; x += 8) {
+            uint64_t srcPixels;
+            memcpy(&srcPixels, src + x, sizeof(srcPixels));
+            if (srcPixels == 0) {
+                continue;
+            }
+
+            // High bit of every non-zero byte.
+            uint64_t opaque = ((srcPixels & kLow7Bits) + kLow7Bits) | srcPixels;
+            opaque &= kHighBits;
+
+            if (opaque == kHighBits) {
+                memcpy(dest + x, &srcPixels, sizeof(srcPixels));
+            } else {
+                uint64_t mask = (opaque >> 7) * 0xFF;
+
+                uint64_t destPixels;
+                memcpy(&destPixels, dest + x, sizeof(destPixels));
+                destPixels = (srcPixels & mask) | (destPixels & ~mask);
+                memcpy(dest + x, &destPixels, sizeof(destPixels));
+            }
+        }
+
+        for (; x < width; x++) {
+            unsigned char c = src[x];
             if (c != 0) {
-                *dest = c;
+                dest[x] = c;
             }
-            dest++;
         }
-        src += srcSkip;
-        dest += destSkip;
+
+        src += srcPitch;
+        dest += destPitch;
     }
 }
 
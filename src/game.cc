@@ -1339,6 +1339,9 @@ static int gameDbInit()
     int patch_index;
     bool is_original = false;
 
+    // CE: Optionally serve .DAT contents from memory mappings.
+    dbSetMemoryMappingEnabled(settings.system.mmap_dat);
+
     // Check if master.dat is the original version (multiple versions?)
     const char* master_path = settings.system.master_dat_path.c_str();
     if (*master_path != '\0') {
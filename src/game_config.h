@@ -32,6 +32,7 @@ namespace fallout {
 #define GAME_CONFIG_HASHING_KEY "hashing"
 #define GAME_CONFIG_SPLASH_KEY "splash"
 #define GAME_CONFIG_FREE_SPACE_KEY "free_space"
+#define GAME_CONFIG_MMAP_DAT_KEY "mmap_dat"
 #define GAME_CONFIG_GAME_WIDTH "game_width"
 #define GAME_CONFIG_GAME_HEIGHT "game_height"
 #define GAME_CONFIG_FULLSCREEN "fullscreen"
@@ -73,6 +74,7 @@ namespace fallout {
 #define GAME_CONFIG_SNDFX_VOLUME_KEY "sndfx_volume"
 #define GAME_CONFIG_SPEECH_VOLUME_KEY "speech_volume"
 #define GAME_CONFIG_CACHE_SIZE_KEY "cache_size"
+#define GAME_CONFIG_PCM_CACHE_SIZE_KEY "pcm_cache_size"
 #define GAME_CONFIG_MUSIC_PATH1_KEY "music_path1"
 #define GAME_CONFIG_MUSIC_PATH2_KEY "music_path2"
 #define GAME_CONFIG_DEBUG_SFXC_KEY "debug_sfxc"
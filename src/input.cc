@@ -939,6 +939,7 @@ void _GNW95_process_message()
         case SDL_WINDOWEVENT:
             switch (e.window.event) {
             case SDL_WINDOWEVENT_EXPOSED:
+                renderInvalidate();
                 windowRefreshAll(&_scr_size);
                 break;
             case SDL_WINDOWEVENT_SIZE_CHANGED:
@@ -955,6 +956,11 @@ void _GNW95_process_message()
                 break;
             }
             break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            // Texture contents might be lost.
+            renderInvalidate();
+            break;
         case SDL_QUIT:
             exit(EXIT_SUCCESS);
             break;
@@ -1,12 +1,17 @@
 #include "interpreter.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <map>
+#include <string>
+#include <unordered_map>
+
 #include "db.h"
 #include "debug.h"
 #include "export.h"
@@ -128,6 +133,51 @@ static void _setupExternalCall(Program* program1, Program* program2, int address
 static void _doEvents();
 static void programListNodeFree(ProgramListNode* programListNode);
 static void interpreterPrintStats();
+static ProgramImage* programImageAcquire(const char* path);
+static void programImageRelease(ProgramImage* image);
+static void programImageCacheTrim(size_t maxSize);
+static unsigned int programStringHash(const char* string);
+static void programStringIndexRemove(Program* program, int offset);
+
+// The maximum size of .INT images kept in [gProgramImages] while no program
+// uses them, so that reentering a map does not read its scripts again.
+#define PROGRAM_IMAGE_CACHE_SIZE (4 * 1024 * 1024)
+
+// Contents of .INT file shared between programs created from the same path.
+//
+// Code, identifiers and static strings are never modified once loaded. The
+// procedure table is not shared because timed and conditional calls keep
+// their state there, so every program makes its own copy of it.
+typedef struct ProgramImage {
+    std::string key;
+    unsigned char* data;
+    int size;
+    int refCount;
+    unsigned int lastUse;
+} ProgramImage;
+
+// Loaded .INT images keyed by lowercased path.
+static std::unordered_map<std::string, ProgramImage*> gProgramImages;
+
+// Total size of images in [gProgramImages] not used by any program.
+static size_t gProgramImagesUnusedSize = 0;
+
+// Monotonic counter to find least recently used image.
+static unsigned int gProgramImagesUseCounter = 0;
+
+// Index of program's dynamic strings heap.
+//
+// Offsets are relative to `dynamicStrings + 4`, the same way they are encoded
+// in `ProgramValue`.
+typedef struct ProgramStringIndex {
+    // Maps string hash to offset of string in heap. Contains strings of
+    // blocks in use only.
+    std::unordered_multimap<unsigned int, int> strings;
+
+    // Maps free block length to offset of its header. Rebuilt by
+    // [programMarkHeap], which is the only place blocks become free.
+    std::multimap<int, int> freeBlocks;
+} ProgramStringIndex;
 
 // 0x50942C
 static char _aCouldnTFindPro[] = "<couldn't find proc>";
@@ -451,7 +501,12 @@ void programFree(Program* program)
         internal_free_safe(program->dynamicStrings, __FILE__, __LINE__); // "..\\int\\INTRPRET.C", 429
     }
 
-    if (program->data != nullptr) {
+    delete program->dynamicStringIndex;
+
+    if (program->image != nullptr) {
+        internal_free_safe(program->procedures, __FILE__, __LINE__);
+        programImageRelease(program->image);
+    } else if (program->data != nullptr) {
         internal_free_safe(program->data, __FILE__, __LINE__); // "..\\int\\INTRPRET.C", 430
     }
 
@@ -468,19 +523,15 @@ void programFree(Program* program)
 // 0x467734
 Program* programCreateByPath(const char* path)
 {
-    File* stream = fileOpen(path, "rb");
-    if (stream == nullptr) {
+    ProgramImage* image = programImageAcquire(path);
+    if (image == nullptr) {
         char err[260];
         snprintf(err, sizeof(err), "Couldn't open %s for read\n", path);
         programFatalError(err);
         return nullptr;
     }
 
-    int fileSize = fileGetSize(stream);
-    unsigned char* data = (unsigned char*)internal_malloc_safe(fileSize, __FILE__, __LINE__); // ..\\int\\INTRPRET.C, 458
-
-    fileRead(data, 1, fileSize, stream);
-    fileClose(stream);
+    unsigned char* data = image->data;
 
     Program* program = (Program*)internal_malloc_safe(sizeof(Program), __FILE__, __LINE__); // ..\\int\\INTRPRET.C, 463
     memset(program, 0, sizeof(Program));
@@ -494,9 +545,14 @@ Program* programCreateByPath(const char* path)
     program->exited = false;
     program->basePointer = -1;
     program->framePointer = -1;
+    program->image = image;
     program->data = data;
-    program->procedures = data + 42;
-    program->identifiers = 24 * stackReadInt32(program->procedures, 0) + program->procedures + 4;
+
+    int proceduresSize = 4 + static_cast<int>(sizeof(Procedure)) * stackReadInt32(data + 42, 0);
+    program->procedures = (unsigned char*)internal_malloc_safe(proceduresSize, __FILE__, __LINE__);
+    memcpy(program->procedures, data + 42, proceduresSize);
+
+    program->identifiers = data + 42 + proceduresSize;
     program->staticStrings = program->identifiers + stackReadInt32(program->identifiers, 0) + 4;
 
     program->stackValues = new ProgramStack();
@@ -505,6 +561,83 @@ Program* programCreateByPath(const char* path)
     return program;
 }
 
+// Returns shared image of the specified .INT file, reading it if needed, or
+// `nullptr` if the file cannot be read.
+static ProgramImage* programImageAcquire(const char* path)
+{
+    std::string key(path);
+    for (char& ch : key) {
+        ch = tolower(static_cast<unsigned char>(ch));
+    }
+
+    ProgramImage* image;
+
+    auto it = gProgramImages.find(key);
+    if (it != gProgramImages.end()) {
+        image = it->second;
+        if (image->refCount == 0) {
+            gProgramImagesUnusedSize -= image->size;
+        }
+    } else {
+        File* stream = fileOpen(path, "rb");
+        if (stream == nullptr) {
+            return nullptr;
+        }
+
+        int fileSize = fileGetSize(stream);
+        unsigned char* data = (unsigned char*)internal_malloc_safe(fileSize, __FILE__, __LINE__); // ..\\int\\INTRPRET.C, 458
+
+        fileRead(data, 1, fileSize, stream);
+        fileClose(stream);
+
+        image = new ProgramImage();
+        image->key = key;
+        image->data = data;
+        image->size = fileSize;
+        image->refCount = 0;
+
+        gProgramImages.emplace(key, image);
+    }
+
+    image->refCount++;
+    image->lastUse = gProgramImagesUseCounter++;
+
+    return image;
+}
+
+static void programImageRelease(ProgramImage* image)
+{
+    image->refCount--;
+    if (image->refCount == 0) {
+        gProgramImagesUnusedSize += image->size;
+        programImageCacheTrim(PROGRAM_IMAGE_CACHE_SIZE);
+    }
+}
+
+// Frees least recently used images not used by any program until their total
+// size is within [maxSize].
+static void programImageCacheTrim(size_t maxSize)
+{
+    while (gProgramImagesUnusedSize > maxSize) {
+        auto victim = gProgramImages.end();
+        for (auto it = gProgramImages.begin(); it != gProgramImages.end(); it++) {
+            ProgramImage* image = it->second;
+            if (image->refCount == 0) {
+                if (victim == gProgramImages.end() || image->lastUse < victim->second->lastUse) {
+                    victim = it;
+                }
+            }
+        }
+
+        ProgramImage* image = victim->second;
+        gProgramImagesUnusedSize -= image->size;
+        gProgramImages.erase(victim);
+
+        internal_free_safe(image->data, __FILE__, __LINE__);
+        delete image;
+    }
+}
+
 // NOTE: Inlined.
 //
 // 0x4678BC
@@ -563,6 +696,9 @@ static void programMarkHeap(Program* program)
         return;
     }
 
+    ProgramStringIndex* index = program->dynamicStringIndex;
+    index->freeBlocks.clear();
+
     ptr = program->dynamicStrings + 4;
     while (*(unsigned short*)ptr != 0x8000) {
         len = *(short*)ptr;
@@ -582,9 +718,15 @@ static void programMarkHeap(Program* program)
                     }
                 }
             }
+
+            index->freeBlocks.emplace(len, static_cast<int>(ptr - (program->dynamicStrings + 4)));
         } else if (*(short*)(ptr + 2) == 0) {
             *(short*)ptr = -len;
             *(short*)(ptr + 2) = 0;
+
+            int offset = static_cast<int>(ptr - (program->dynamicStrings + 4));
+            programStringIndexRemove(program, offset + 4);
+            index->freeBlocks.emplace(len, offset);
         }
 
         ptr += len + 4;
@@ -609,42 +751,52 @@ int programPushString(Program* program, const char* const string)
         v27++;
     }
 
-    if (program->dynamicStrings != nullptr) {
-        // TODO: Needs testing, lots of pointer stuff.
-        unsigned char* heap = program->dynamicStrings + 4;
-        while (*(unsigned short*)heap != 0x8000) {
-            short v2 = *(short*)heap;
-            if (v2 >= 0) {
-                if (v2 == v27) {
-                    if (strcmp(string, (char*)(heap + 4)) == 0) {
-                        return (heap + 4) - (program->dynamicStrings + 4);
-                    }
-                }
-            } else {
-                v2 = -v2;
-                if (v2 > v27) {
-                    if (v2 - v27 <= 4) {
-                        *(short*)heap = v2;
-                    } else {
-                        *(short*)(heap + v27 + 6) = 0;
-                        *(short*)(heap + v27 + 4) = -(v2 - v27 - 4);
-                        *(short*)(heap) = v27;
-                    }
-
-                    *(short*)(heap + 2) = 0;
-                    strcpy((char*)(heap + 4), string);
-
-                    *(heap + v27 + 3) = '\0';
-                    return (heap + 4) - (program->dynamicStrings + 4);
-                }
-            }
-            heap += v2 + 4;
-        }
-    } else {
+    if (program->dynamicStrings == nullptr) {
         program->dynamicStrings = (unsigned char*)internal_malloc_safe(8, __FILE__, __LINE__); // "..\\int\\INTRPRET.C", 631
         *(int*)(program->dynamicStrings) = 0;
         *(unsigned short*)(program->dynamicStrings + 4) = 0x8000;
         *(short*)(program->dynamicStrings + 6) = 1;
+
+        program->dynamicStringIndex = new ProgramStringIndex();
+    }
+
+    ProgramStringIndex* index = program->dynamicStringIndex;
+    unsigned int hash = programStringHash(string);
+
+    // CE: The original code walks entire heap looking for either the same
+    // string or a free block large enough to hold it. Both are looked up via
+    // index instead.
+    auto range = index->strings.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+        if (strcmp(string, (char*)(program->dynamicStrings + 4 + it->second)) == 0) {
+            return it->second;
+        }
+    }
+
+    auto freeBlock = index->freeBlocks.upper_bound(v27);
+    if (freeBlock != index->freeBlocks.end()) {
+        short v2 = freeBlock->first;
+        int offset = freeBlock->second;
+        index->freeBlocks.erase(freeBlock);
+
+        unsigned char* heap = program->dynamicStrings + 4 + offset;
+        if (v2 - v27 <= 4) {
+            *(short*)heap = v2;
+        } else {
+            *(short*)(heap + v27 + 6) = 0;
+            *(short*)(heap + v27 + 4) = -(v2 - v27 - 4);
+            *(short*)(heap) = v27;
+
+            index->freeBlocks.emplace(v2 - v27 - 4, offset + v27 + 4);
+        }
+
+        *(short*)(heap + 2) = 0;
+        strcpy((char*)(heap + 4), string);
+
+        *(heap + v27 + 3) = '\0';
+
+        index->strings.emplace(hash, offset + 4);
+        return offset + 4;
     }
 
     program->dynamicStrings = (unsigned char*)internal_realloc_safe(program->dynamicStrings, *(int*)(program->dynamicStrings) + 8 + 4 + v27, __FILE__, __LINE__); // "..\\int\\INTRPRET.C", 640
@@ -666,7 +818,36 @@ int programPushString(Program* program, const char* const string)
     *(unsigned short*)(v23 + 4) = 0x8000;
     *(short*)(v23 + 6) = 1;
 
-    return v20 + 4 - (program->dynamicStrings + 4);
+    int offset = static_cast<int>(v20 + 4 - (program->dynamicStrings + 4));
+    index->strings.emplace(hash, offset);
+    return offset;
+}
+
+// FNV-1a hash of dynamic string.
+static unsigned int programStringHash(const char* string)
+{
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* ch = (const unsigned char*)string; *ch != '\0'; ch++) {
+        hash ^= *ch;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Removes string at [offset] from index, should be called before its block
+// is reused.
+static void programStringIndexRemove(Program* program, int offset)
+{
+    ProgramStringIndex* index = program->dynamicStringIndex;
+    unsigned int hash = programStringHash((char*)(program->dynamicStrings + 4 + offset));
+
+    auto range = index->strings.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+        if (it->second == offset) {
+            index->strings.erase(it);
+            break;
+        }
+    }
 }
 
 // 0x467C90
@@ -2613,6 +2794,8 @@ void _interpretClose()
 {
     externalVariablesClear();
     intLibExit();
+
+    programImageCacheTrim(0);
 }
 
 // 0x46CCA4
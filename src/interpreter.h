@@ -166,6 +166,8 @@ public:
 typedef std::vector<ProgramValue> ProgramStack;
 
 typedef struct Program Program;
+typedef struct ProgramImage ProgramImage;
+typedef struct ProgramStringIndex ProgramStringIndex;
 typedef int(InterpretCheckWaitFunc)(Program* program);
 
 // It's size in original code is 144 (0x8C) bytes due to the different
@@ -192,6 +194,13 @@ typedef struct Program {
     bool exited;
     ProgramStack* stackValues;
     ProgramStack* returnStackValues;
+
+    // Shared .INT file contents [data], [identifiers] and [staticStrings]
+    // point into. [procedures] is a private copy owned by the program.
+    ProgramImage* image;
+
+    // Lookup structures for [dynamicStrings], created along with it.
+    ProgramStringIndex* dynamicStringIndex;
 } Program;
 
 typedef unsigned int(InterpretTimerFunc)();
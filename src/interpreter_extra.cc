@@ -2103,6 +2103,7 @@ static void opSetObjectVisibility(Program* program)
             if (objectHide(obj, &rect) != -1) {
                 if (PID_TYPE(obj->pid) == OBJ_TYPE_CRITTER) {
                     obj->flags |= OBJECT_NO_BLOCK;
+                    objectInvalidateBlocking(obj->elevation);
                 }
 
                 tileWindowRefreshRect(&rect, obj->elevation);
@@ -290,6 +290,16 @@ typedef struct Object {
 typedef struct ObjectListNode {
     Object* obj;
     struct ObjectListNode* next;
+
+    // CE: Links in the registry of objects of the same type on the same
+    // elevation (see `object.cc`), and index of that registry (or -1 if node
+    // is not registered). Tile and multihex flag are the ones object had when
+    // it was registered.
+    struct ObjectListNode* prevOfType;
+    struct ObjectListNode* nextOfType;
+    int registry;
+    int registryTile;
+    bool registryMultihex;
 } ObjectListNode;
 
 #define BUILT_TILE_TILE_MASK 0x3FFFFFF
@@ -1,9 +1,11 @@
 #include "object.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <algorithm>
+#include <unordered_map>
 
 #include "animation.h"
 #include "art.h"
@@ -59,6 +61,16 @@ static int _obj_adjust_light(Object* obj, int a2, Rect* rect);
 static void objectDrawOutline(Object* object, Rect* rect);
 static void _obj_render_object(Object* object, Rect* rect, int light);
 static int _obj_preload_sort(const void* a1, const void* a2);
+static void objectIndexAdd(Object* obj);
+static void objectIndexRemove(Object* obj);
+static Object* objectIndexFind(int id, int type);
+static void objectBlockingChanged(Object* obj);
+static void objectRegistryAdd(ObjectListNode* node);
+static void objectRegistryRemove(ObjectListNode* node);
+static ObjectListNode* objectRegistryGetHead(int elevation, int objectType);
+static bool objectFindNextTileAtElevation();
+static void objectUpdateTileBlockers(ObjectListNode* node, int delta);
+static bool objectTileHasNoBlockers(int tile, int elevation);
 
 // 0x5195F8
 static bool gObjectsInitialized = false;
@@ -115,6 +127,52 @@ static int gObjectFindTile = 0;
 // 0x519638
 static ObjectListNode* gObjectFindLastObjectListNode = nullptr;
 
+// Maps object id to object. Object ids can be reassigned in place (e.g. by
+// party member or dude restoration code), so entries are only hints that
+// are validated on lookup, with fallback to scanning tiles.
+static std::unordered_map<int, Object*> gObjectsById;
+
+// Maps object to the id it's registered with in [gObjectsById], used to
+// unregister objects being deallocated.
+static std::unordered_map<Object*, int> gObjectIdsByObject;
+
+// Number of [objectFindById] lookups and how many of them were resolved by
+// [gObjectsById] without scanning tiles.
+static unsigned int gObjectFindByIdLookups = 0;
+static unsigned int gObjectFindByIdHits = 0;
+
+// Per-elevation counters bumped whenever set of objects which can block
+// movement on that elevation might have changed (objects linked, unlinked,
+// moved, shown, hidden, or changed their fid).
+static unsigned int gObjectBlockingGeneration[ELEVATION_COUNT];
+
+// Object temporarily hidden by [objectBeginIgnoreBlocking], or `nullptr`.
+static Object* gObjectBlockingIgnored = nullptr;
+
+// Whether [gObjectBlockingIgnored] was hidden before it was ignored.
+static bool gObjectBlockingIgnoredWasHidden = false;
+
+// Number of object types in object registries (all values of [FID_TYPE]).
+#define OBJECT_REGISTRY_TYPE_COUNT 16
+
+// Registries of objects bound to tiles, one per elevation and object type
+// (as seen in object fid). Each registry is a list of object list nodes
+// linked via `prevOfType` and `nextOfType` and sorted by tile, so whole map
+// enumerations only visit tiles with objects of interest instead of all
+// hexes.
+static ObjectListNode* gObjectRegistryHeads[ELEVATION_COUNT * OBJECT_REGISTRY_TYPE_COUNT];
+static ObjectListNode* gObjectRegistryTails[ELEVATION_COUNT * OBJECT_REGISTRY_TYPE_COUNT];
+
+// Number of objects which can block tiles (critters, scenery and walls,
+// regardless of their flags) registered on each tile, plus number of such
+// multihex objects registered on adjacent tiles. When it's zero, none of
+// blocking predicates can find anything at the tile.
+static unsigned short gObjectTileBlockers[ELEVATION_COUNT][HEX_GRID_SIZE];
+
+// Position of [objectFindNextAtElevation] in each registry of
+// [gObjectFindElevation] - the first node past [gObjectFindTile].
+static ObjectListNode* gObjectFindRegistryNodes[OBJECT_REGISTRY_TYPE_COUNT];
+
 // 0x51963C
 static int* gObjectFids = nullptr;
 
@@ -391,6 +449,8 @@ void objectsExit()
         gDude->flags &= ~OBJECT_NO_REMOVE;
         gEgg->flags &= ~OBJECT_NO_REMOVE;
 
+        objectPrintFindByIdStats();
+
         _obj_remove_all();
         textObjectsFree();
 
@@ -912,6 +972,7 @@ int objectCreateWithFidPid(Object** objectPtr, int fid, int pid)
 
     objectListNode->obj->pid = pid;
     objectListNode->obj->id = scriptsNewObjectId();
+    objectIndexAdd(objectListNode->obj);
 
     if (pid == -1 || PID_TYPE(pid) == OBJ_TYPE_TILE) {
         Inventory* inventory = &(objectListNode->obj->data.inventory);
@@ -1023,6 +1084,7 @@ int _obj_copy(Object** a1, Object* a2)
     _obj_insert(objectListNode);
 
     objectListNode->obj->id = scriptsNewObjectId();
+    objectIndexAdd(objectListNode->obj);
 
     if (objectListNode->obj->sid != -1) {
         objectListNode->obj->sid = -1;
@@ -1123,9 +1185,12 @@ int _obj_disconnect(Object* obj, Rect* rect)
     }
 
     if (node != nullptr) {
+        objectRegistryRemove(node);
         internal_free(node);
     }
 
+    objectBlockingChanged(obj);
+
     obj->tile = -1;
 
     return 0;
@@ -1383,6 +1448,8 @@ int objectSetLocation(Object* obj, int tile, int elevation, Rect* rect)
     }
 
     int oldElevation = obj->elevation;
+    objectBlockingChanged(obj);
+
     if (prevNode != nullptr) {
         prevNode->next = node->next;
     } else {
@@ -1522,6 +1589,8 @@ int objectSetFid(Object* obj, int fid, Rect* dirtyRect)
         return -1;
     }
 
+    int oldType = FID_TYPE(obj->fid);
+
     if (dirtyRect != nullptr) {
         objectGetRect(obj, dirtyRect);
 
@@ -1533,6 +1602,17 @@ int objectSetFid(Object* obj, int fid, Rect* dirtyRect)
         obj->fid = fid;
     }
 
+    // CE: Move object to the registry of its new type.
+    if (FID_TYPE(fid) != oldType && obj->tile != -1) {
+        ObjectListNode* node;
+        ObjectListNode* prevNode;
+        if (objectGetListNode(obj, &node, &prevNode) == 0) {
+            objectRegistryAdd(node);
+        }
+    }
+
+    objectBlockingChanged(obj);
+
     return 0;
 }
 
@@ -1829,6 +1909,7 @@ int objectShow(Object* obj, Rect* rect)
 
     obj->flags &= ~OBJECT_HIDDEN;
     obj->outline &= ~OUTLINE_DISABLED;
+    objectBlockingChanged(obj);
 
     if (_obj_adjust_light(obj, 0, rect) == -1) {
         if (rect != nullptr) {
@@ -1865,6 +1946,7 @@ int objectHide(Object* object, Rect* rect)
     }
 
     object->flags |= OBJECT_HIDDEN;
+    objectBlockingChanged(object);
 
     if ((object->outline & OUTLINE_TYPE_MASK) != 0) {
         object->outline |= OUTLINE_DISABLED;
@@ -2086,9 +2168,18 @@ bool _obj_portal_is_walk_thru(Object* obj)
 // 0x48B2E8
 Object* objectFindById(int a1)
 {
-    Object* obj = objectFindFirst();
+    gObjectFindByIdLookups++;
+
+    Object* obj = objectIndexFind(a1, -1);
+    if (obj != nullptr) {
+        gObjectFindByIdHits++;
+        return obj;
+    }
+
+    obj = objectFindFirst();
     while (obj != nullptr) {
         if (obj->id == a1) {
+            objectIndexAdd(obj);
             return obj;
         }
         obj = objectFindNext();
@@ -2213,7 +2304,13 @@ Object* objectFindFirstAtElevation(int elevation)
     gObjectFindElevation = elevation;
     gObjectFindTile = 0;
 
-    for (gObjectFindTile = 0; gObjectFindTile < HEX_GRID_SIZE; gObjectFindTile++) {
+    // CE: Walk tiles listed in registries of this elevation rather than all
+    // hexes.
+    for (int objectType = 0; objectType < OBJECT_REGISTRY_TYPE_COUNT; objectType++) {
+        gObjectFindRegistryNodes[objectType] = objectRegistryGetHead(elevation, objectType);
+    }
+
+    while (objectFindNextTileAtElevation()) {
         ObjectListNode* objectListNode = gObjectListHeadByTile[gObjectFindTile];
         while (objectListNode != nullptr) {
             Object* object = objectListNode->obj;
@@ -2242,8 +2339,7 @@ Object* objectFindNextAtElevation()
 
     while (true) {
         if (objectListNode == nullptr) {
-            gObjectFindTile++;
-            if (gObjectFindTile >= HEX_GRID_SIZE) {
+            if (!objectFindNextTileAtElevation()) {
                 break;
             }
 
@@ -2266,6 +2362,35 @@ Object* objectFindNextAtElevation()
     return nullptr;
 }
 
+// Moves [gObjectFindTile] to the next tile with objects on
+// [gObjectFindElevation], merging registries of all object types.
+static bool objectFindNextTileAtElevation()
+{
+    int tile = -1;
+    for (int objectType = 0; objectType < OBJECT_REGISTRY_TYPE_COUNT; objectType++) {
+        ObjectListNode* node = gObjectFindRegistryNodes[objectType];
+        if (node != nullptr && (tile == -1 || node->registryTile < tile)) {
+            tile = node->registryTile;
+        }
+    }
+
+    if (tile == -1) {
+        return false;
+    }
+
+    for (int objectType = 0; objectType < OBJECT_REGISTRY_TYPE_COUNT; objectType++) {
+        ObjectListNode* node = gObjectFindRegistryNodes[objectType];
+        while (node != nullptr && node->registryTile == tile) {
+            node = node->nextOfType;
+        }
+        gObjectFindRegistryNodes[objectType] = node;
+    }
+
+    gObjectFindTile = tile;
+
+    return true;
+}
+
 // 0x48B5A8
 Object* objectFindFirstAtLocation(int elevation, int tile)
 {
@@ -2410,6 +2535,11 @@ Object* _obj_blocking_at(Object* excludeObj, int tile, int elev)
         return nullptr;
     }
 
+    // CE: Fast path for tiles without potential blockers.
+    if (objectTileHasNoBlockers(tile, elev)) {
+        return nullptr;
+    }
+
     objectListNode = gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         obj = objectListNode->obj;
@@ -2459,6 +2589,11 @@ Object* _obj_shoot_blocking_at(Object* excludeObj, int tile, int elev)
         return nullptr;
     }
 
+    // CE: Fast path for tiles without potential blockers.
+    if (objectTileHasNoBlockers(tile, elev)) {
+        return nullptr;
+    }
+
     ObjectListNode* objectListItem = gObjectListHeadByTile[tile];
     while (objectListItem != nullptr) {
         Object* candidate = objectListItem->obj;
@@ -2515,6 +2650,11 @@ Object* _obj_ai_blocking_at(Object* excludeObj, int tile, int elevation)
         return nullptr;
     }
 
+    // CE: Fast path for tiles without potential blockers.
+    if (objectTileHasNoBlockers(tile, elevation)) {
+        return nullptr;
+    }
+
     ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         Object* object = objectListNode->obj;
@@ -2598,6 +2738,11 @@ int _obj_scroll_blocking_at(int tile, int elev)
 // 0x48BB88
 Object* _obj_sight_blocking_at(Object* excludeObj, int tile, int elevation)
 {
+    // CE: Fast path for tiles without potential blockers.
+    if (objectTileHasNoBlockers(tile, elevation)) {
+        return nullptr;
+    }
+
     ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         Object* object = objectListNode->obj;
@@ -2671,19 +2816,29 @@ int objectListCreate(int tile, int elevation, int objectType, Object*** objectLi
         return -1;
     }
 
+    // CE: When listing whole elevation only tiles from registry of requested
+    // object type are visited. Objects on these tiles are still collected by
+    // walking tile lists to keep the original order.
     int count = 0;
     if (tile == -1) {
-        for (int index = 0; index < HEX_GRID_SIZE; index++) {
-            ObjectListNode* objectListNode = gObjectListHeadByTile[index];
-            while (objectListNode != nullptr) {
-                Object* obj = objectListNode->obj;
-                if ((obj->flags & OBJECT_HIDDEN) == 0
-                    && obj->elevation == elevation
-                    && FID_TYPE(obj->fid) == objectType) {
-                    count++;
+        int lastTile = -1;
+        ObjectListNode* registryNode = objectRegistryGetHead(elevation, objectType);
+        while (registryNode != nullptr) {
+            if (registryNode->registryTile != lastTile) {
+                lastTile = registryNode->registryTile;
+
+                ObjectListNode* objectListNode = gObjectListHeadByTile[lastTile];
+                while (objectListNode != nullptr) {
+                    Object* obj = objectListNode->obj;
+                    if ((obj->flags & OBJECT_HIDDEN) == 0
+                        && obj->elevation == elevation
+                        && FID_TYPE(obj->fid) == objectType) {
+                        count++;
+                    }
+                    objectListNode = objectListNode->next;
                 }
-                objectListNode = objectListNode->next;
             }
+            registryNode = registryNode->nextOfType;
         }
     } else {
         ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
@@ -2708,17 +2863,24 @@ int objectListCreate(int tile, int elevation, int objectType, Object*** objectLi
     }
 
     if (tile == -1) {
-        for (int index = 0; index < HEX_GRID_SIZE; index++) {
-            ObjectListNode* objectListNode = gObjectListHeadByTile[index];
-            while (objectListNode) {
-                Object* obj = objectListNode->obj;
-                if ((obj->flags & OBJECT_HIDDEN) == 0
-                    && obj->elevation == elevation
-                    && FID_TYPE(obj->fid) == objectType) {
-                    *objects++ = obj;
+        int lastTile = -1;
+        ObjectListNode* registryNode = objectRegistryGetHead(elevation, objectType);
+        while (registryNode != nullptr) {
+            if (registryNode->registryTile != lastTile) {
+                lastTile = registryNode->registryTile;
+
+                ObjectListNode* objectListNode = gObjectListHeadByTile[lastTile];
+                while (objectListNode != nullptr) {
+                    Object* obj = objectListNode->obj;
+                    if ((obj->flags & OBJECT_HIDDEN) == 0
+                        && obj->elevation == elevation
+                        && FID_TYPE(obj->fid) == objectType) {
+                        *objects++ = obj;
+                    }
+                    objectListNode = objectListNode->next;
                 }
-                objectListNode = objectListNode->next;
             }
+            registryNode = registryNode->nextOfType;
         }
     } else {
         ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
@@ -2769,93 +2931,115 @@ void _translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeig
     }
 }
 
+// CE: Returns `true` if next 8 bytes of sprite are all transparent, which is
+// common on the edges of critter frames.
+static inline bool _trans_span_is_empty(const unsigned char* src)
+{
+    uint64_t pixels;
+    memcpy(&pixels, src, sizeof(pixels));
+    return pixels == 0;
+}
+
 // 0x48BEFC
 void _dark_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int intensity)
 {
     unsigned char* sp = src;
     unsigned char* dp = dest + destPitch * destY + destX;
 
-    int srcStep = srcPitch - srcWidth;
-    int destStep = destPitch - srcWidth;
     int intensityIndex = intensity / 512;
 
-    for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
-            unsigned char color = *sp;
-            if (color != 0) {
-                if (color < 0xE5) {
-                    color = intensityColorTable[color][intensityIndex];
-                }
+    const unsigned char* lut = colorGetIntensityLut(intensityIndex, true);
 
-                *dp = color;
+    for (int y = 0; y < srcHeight; y++) {
+        int x = 0;
+        while (x < srcWidth) {
+            if (srcWidth - x >= 8 && _trans_span_is_empty(sp + x)) {
+                x += 8;
+                continue;
             }
 
-            sp++;
-            dp++;
+            int spanEnd = std::min(x + 8, srcWidth);
+            for (; x < spanEnd; x++) {
+                unsigned char color = sp[x];
+                if (color != 0) {
+                    dp[x] = lut[color];
+                }
+            }
         }
 
-        sp += srcStep;
-        dp += destStep;
+        sp += srcPitch;
+        dp += destPitch;
     }
 }
 
 // 0x48BF88
 void _dark_translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int intensity, unsigned char* a10, unsigned char* a11)
 {
-    int srcStep = srcPitch - srcWidth;
-    int destStep = destPitch - srcWidth;
     int intensityIndex = intensity / 512;
 
+    const unsigned char* lut = colorGetIntensityLut(intensityIndex, false);
+
     dest += destPitch * destY + destX;
 
     for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
-            unsigned char srcByte = *src;
-            if (srcByte != 0) {
-                unsigned char destByte = *dest;
-                unsigned int index = a11[srcByte] << 8;
-                index = a10[index + destByte];
-                *dest = intensityColorTable[index][intensityIndex];
+        int x = 0;
+        while (x < srcWidth) {
+            if (srcWidth - x >= 8 && _trans_span_is_empty(src + x)) {
+                x += 8;
+                continue;
             }
 
-            src++;
-            dest++;
+            int spanEnd = std::min(x + 8, srcWidth);
+            for (; x < spanEnd; x++) {
+                unsigned char srcByte = src[x];
+                if (srcByte != 0) {
+                    unsigned char destByte = dest[x];
+                    unsigned int index = a11[srcByte] << 8;
+                    index = a10[index + destByte];
+                    dest[x] = lut[index];
+                }
+            }
         }
 
-        src += srcStep;
-        dest += destStep;
+        src += srcPitch;
+        dest += destPitch;
     }
 }
 
 // 0x48C03C
 void _intensity_mask_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destPitch, unsigned char* mask, int maskPitch, int intensity)
 {
-    int srcStep = srcPitch - srcWidth;
-    int destStep = destPitch - srcWidth;
-    int maskStep = maskPitch - srcWidth;
     int intensityIndex = intensity / 512;
 
+    const unsigned char* lut = colorGetIntensityLut(intensityIndex, false);
+
     for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
-            unsigned char color = *src;
-            if (color != 0) {
-                color = intensityColorTable[color][intensityIndex];
-                if (*mask != 0) {
-                    unsigned char v1 = intensityColorTable[*dest][128 - *mask];
-                    unsigned char v2 = intensityColorTable[color][*mask];
-                    color = colorMixAddTable[v2][v1];
-                }
-                *dest = color;
+        int x = 0;
+        while (x < srcWidth) {
+            if (srcWidth - x >= 8 && _trans_span_is_empty(src + x)) {
+                x += 8;
+                continue;
             }
 
-            src++;
-            dest++;
-            mask++;
+            int spanEnd = std::min(x + 8, srcWidth);
+            for (; x < spanEnd; x++) {
+                unsigned char color = src[x];
+                if (color != 0) {
+                    color = lut[color];
+                    unsigned char maskByte = mask[x];
+                    if (maskByte != 0) {
+                        unsigned char v1 = intensityColorTable[dest[x]][128 - maskByte];
+                        unsigned char v2 = intensityColorTable[color][maskByte];
+                        color = colorMixAddTable[v2][v1];
+                    }
+                    dest[x] = color;
+                }
+            }
         }
 
-        src += srcStep;
-        dest += destStep;
-        mask += maskStep;
+        src += srcPitch;
+        dest += destPitch;
+        mask += maskPitch;
     }
 }
 
@@ -3563,6 +3747,8 @@ static int _obj_load_obj(File* stream, Object** objectPtr, int elevation, Object
         return -1;
     }
 
+    objectIndexAdd(obj);
+
     if (obj->sid != -1) {
         Script* script;
         if (scriptGetScript(obj->sid, &script) == -1) {
@@ -3753,6 +3939,8 @@ static void objectDeallocate(Object** objectPtr)
         return;
     }
 
+    objectIndexRemove(*objectPtr);
+
     internal_free(*objectPtr);
 
     *objectPtr = nullptr;
@@ -3774,6 +3962,11 @@ static int objectListNodeCreate(ObjectListNode** nodePtr)
 
     node->obj = nullptr;
     node->next = nullptr;
+    node->prevOfType = nullptr;
+    node->nextOfType = nullptr;
+    node->registry = -1;
+    node->registryTile = -1;
+    node->registryMultihex = false;
 
     return 0;
 }
@@ -3791,6 +3984,8 @@ static void objectListNodeDestroy(ObjectListNode** nodePtr)
         return;
     }
 
+    objectRegistryRemove(*nodePtr);
+
     internal_free(*nodePtr);
 
     *nodePtr = nullptr;
@@ -3901,6 +4096,9 @@ static void _obj_insert(ObjectListNode* objectListNode)
 
     objectListNode->next = *objectListNodePtr;
     *objectListNodePtr = objectListNode;
+
+    objectRegistryAdd(objectListNode);
+    objectBlockingChanged(objectListNode->obj);
 }
 
 // 0x48DA58
@@ -3921,6 +4119,8 @@ static int _obj_remove(ObjectListNode* a1, ObjectListNode* a2)
         scriptRemove(a1->obj->sid);
     }
 
+    objectBlockingChanged(a1->obj);
+
     if (a1 != a2) {
         if (a2 != nullptr) {
             a2->next = a1->next;
@@ -5185,9 +5385,18 @@ static int _obj_preload_sort(const void* a1, const void* a2)
 
 Object* objectTypedFindById(int id, int type)
 {
-    Object* obj = objectFindFirst();
+    gObjectFindByIdLookups++;
+
+    Object* obj = objectIndexFind(id, type);
+    if (obj != nullptr) {
+        gObjectFindByIdHits++;
+        return obj;
+    }
+
+    obj = objectFindFirst();
     while (obj != nullptr) {
         if (obj->id == id && PID_TYPE(obj->pid) == type) {
+            objectIndexAdd(obj);
             return obj;
         }
         obj = objectFindNext();
@@ -5196,6 +5405,278 @@ Object* objectTypedFindById(int id, int type)
     return nullptr;
 }
 
+void objectPrintFindByIdStats()
+{
+    debugPrint("Object id lookups: %u, resolved by index: %u\n", gObjectFindByIdLookups, gObjectFindByIdHits);
+}
+
+unsigned int objectGetBlockingGeneration(int elevation)
+{
+    if (!elevationIsValid(elevation)) {
+        return 0;
+    }
+
+    return gObjectBlockingGeneration[elevation];
+}
+
+// Marks blocking state of [elevation] as changed, or all elevations when
+// [elevation] is -1. Should be used by code which toggles blocking related
+// flags directly.
+void objectInvalidateBlocking(int elevation)
+{
+    if (elevation == -1) {
+        for (int index = 0; index < ELEVATION_COUNT; index++) {
+            gObjectBlockingGeneration[index]++;
+        }
+    } else if (elevationIsValid(elevation)) {
+        gObjectBlockingGeneration[elevation]++;
+    }
+}
+
+// Temporarily hides [obj] so that path searches go through it. Unlike toggling
+// [OBJECT_HIDDEN] directly this does not change blocking generation - path
+// cache uses [objectGetBlockingIgnored] as part of its key instead, so results
+// computed while [obj] is hidden can be reused next time the same object is
+// ignored. Must be paired with [objectEndIgnoreBlocking] and cannot be nested.
+void objectBeginIgnoreBlocking(Object* obj)
+{
+    gObjectBlockingIgnored = obj;
+    gObjectBlockingIgnoredWasHidden = (obj->flags & OBJECT_HIDDEN) != 0;
+    obj->flags |= OBJECT_HIDDEN;
+}
+
+// Unhides object hidden by [objectBeginIgnoreBlocking].
+void objectEndIgnoreBlocking(Object* obj)
+{
+    obj->flags &= ~OBJECT_HIDDEN;
+    gObjectBlockingIgnored = nullptr;
+
+    // Object was hidden for real, unhiding it changes blocking state.
+    if (gObjectBlockingIgnoredWasHidden) {
+        objectInvalidateBlocking(obj->elevation);
+    }
+}
+
+Object* objectGetBlockingIgnored()
+{
+    return gObjectBlockingIgnored;
+}
+
+// Should be called after replacing object flags directly, so that
+// registries pick up flags they depend on (e.g. `OBJECT_MULTIHEX`).
+void objectFlagsChanged(Object* obj)
+{
+    if (obj->tile != -1) {
+        ObjectListNode* node;
+        ObjectListNode* prevNode;
+        if (objectGetListNode(obj, &node, &prevNode) == 0) {
+            objectRegistryAdd(node);
+        }
+    }
+
+    objectBlockingChanged(obj);
+}
+
+static void objectBlockingChanged(Object* obj)
+{
+    if (obj->tile != -1) {
+        objectInvalidateBlocking(obj->elevation);
+    }
+}
+
+// Adds node to the registry matching its object's elevation and type, moving
+// it from the registry it's currently in (if any). Nodes of objects which are
+// not bound to tiles are not registered.
+static void objectRegistryAdd(ObjectListNode* node)
+{
+    objectRegistryRemove(node);
+
+    Object* obj = node->obj;
+    if (obj->tile == -1 || !elevationIsValid(obj->elevation)) {
+        return;
+    }
+
+    int registry = obj->elevation * OBJECT_REGISTRY_TYPE_COUNT + (FID_TYPE(obj->fid));
+
+    // Objects are mostly added in ascending tile order (e.g. when loading
+    // map), so look for insertion point from the tail.
+    ObjectListNode* prev = gObjectRegistryTails[registry];
+    while (prev != nullptr && prev->registryTile > obj->tile) {
+        prev = prev->prevOfType;
+    }
+
+    node->prevOfType = prev;
+    if (prev != nullptr) {
+        node->nextOfType = prev->nextOfType;
+        prev->nextOfType = node;
+    } else {
+        node->nextOfType = gObjectRegistryHeads[registry];
+        gObjectRegistryHeads[registry] = node;
+    }
+
+    if (node->nextOfType != nullptr) {
+        node->nextOfType->prevOfType = node;
+    } else {
+        gObjectRegistryTails[registry] = node;
+    }
+
+    node->registry = registry;
+    node->registryTile = obj->tile;
+    node->registryMultihex = (obj->flags & OBJECT_MULTIHEX) != 0;
+
+    objectUpdateTileBlockers(node, 1);
+}
+
+static void objectRegistryRemove(ObjectListNode* node)
+{
+    if (node->registry == -1) {
+        return;
+    }
+
+    objectUpdateTileBlockers(node, -1);
+
+    if (node->prevOfType != nullptr) {
+        node->prevOfType->nextOfType = node->nextOfType;
+    } else {
+        gObjectRegistryHeads[node->registry] = node->nextOfType;
+    }
+
+    if (node->nextOfType != nullptr) {
+        node->nextOfType->prevOfType = node->prevOfType;
+    } else {
+        gObjectRegistryTails[node->registry] = node->prevOfType;
+    }
+
+    node->prevOfType = nullptr;
+    node->nextOfType = nullptr;
+    node->registry = -1;
+    node->registryTile = -1;
+    node->registryMultihex = false;
+}
+
+static void objectUpdateTileBlockers(ObjectListNode* node, int delta)
+{
+    int elevation = node->registry / OBJECT_REGISTRY_TYPE_COUNT;
+    int objectType = node->registry % OBJECT_REGISTRY_TYPE_COUNT;
+    if (objectType != OBJ_TYPE_CRITTER
+        && objectType != OBJ_TYPE_SCENERY
+        && objectType != OBJ_TYPE_WALL) {
+        return;
+    }
+
+    int tile = node->registryTile;
+    gObjectTileBlockers[elevation][tile] += delta;
+
+    if (node->registryMultihex) {
+        // Every tile adjacent to the object's tile (as seen by
+        // [tileGetTileInDirection], including edge tiles) is within one row
+        // and one column of it, so whole 3x3 block is marked.
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int adjacentTile = tile + dy * HEX_GRID_WIDTH + dx;
+                if (adjacentTile != tile && hexGridTileIsValid(adjacentTile)) {
+                    gObjectTileBlockers[elevation][adjacentTile] += delta;
+                }
+            }
+        }
+    }
+}
+
+// Returns `true` if none of blocking predicates can find anything at the
+// tile, without walking object lists.
+static bool objectTileHasNoBlockers(int tile, int elevation)
+{
+    return hexGridTileIsValid(tile)
+        && elevationIsValid(elevation)
+        && gObjectTileBlockers[elevation][tile] == 0;
+}
+
+static ObjectListNode* objectRegistryGetHead(int elevation, int objectType)
+{
+    if (!elevationIsValid(elevation)) {
+        return nullptr;
+    }
+
+    if (objectType < 0 || objectType >= OBJECT_REGISTRY_TYPE_COUNT) {
+        return nullptr;
+    }
+
+    return gObjectRegistryHeads[elevation * OBJECT_REGISTRY_TYPE_COUNT + objectType];
+}
+
+// Registers object under its current id, replacing registration under
+// previous id (if any).
+static void objectIndexAdd(Object* obj)
+{
+    auto it = gObjectIdsByObject.find(obj);
+    if (it != gObjectIdsByObject.end()) {
+        if (it->second == obj->id) {
+            return;
+        }
+
+        auto prev = gObjectsById.find(it->second);
+        if (prev != gObjectsById.end() && prev->second == obj) {
+            gObjectsById.erase(prev);
+        }
+    }
+
+    if (obj->id == -1) {
+        if (it != gObjectIdsByObject.end()) {
+            gObjectIdsByObject.erase(it);
+        }
+        return;
+    }
+
+    auto other = gObjectsById.find(obj->id);
+    if (other != gObjectsById.end() && other->second != obj) {
+        gObjectIdsByObject.erase(other->second);
+    }
+
+    gObjectsById[obj->id] = obj;
+    gObjectIdsByObject[obj] = obj->id;
+}
+
+static void objectIndexRemove(Object* obj)
+{
+    auto it = gObjectIdsByObject.find(obj);
+    if (it == gObjectIdsByObject.end()) {
+        return;
+    }
+
+    auto entry = gObjectsById.find(it->second);
+    if (entry != gObjectsById.end() && entry->second == obj) {
+        gObjectsById.erase(entry);
+    }
+
+    gObjectIdsByObject.erase(it);
+}
+
+// Returns object registered with the specified id if it still has this id
+// and is reachable by [objectFindFirst]/[objectFindNext], otherwise returns
+// `nullptr`. Pass -1 as [type] to accept objects of any type.
+static Object* objectIndexFind(int id, int type)
+{
+    auto it = gObjectsById.find(id);
+    if (it == gObjectsById.end()) {
+        return nullptr;
+    }
+
+    Object* obj = it->second;
+    if (obj->id != id || obj->tile == -1) {
+        return nullptr;
+    }
+
+    if (type != -1 && PID_TYPE(obj->pid) != type) {
+        return nullptr;
+    }
+
+    if (artIsObjectTypeHidden(FID_TYPE(obj->fid))) {
+        return nullptr;
+    }
+
+    return obj;
+}
+
 bool isExitGridAt(int tile, int elevation)
 {
     ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
@@ -100,6 +100,13 @@ int _obj_load_dude(File* stream);
 void _obj_fix_violence_settings(int* fid);
 
 Object* objectTypedFindById(int id, int type);
+void objectPrintFindByIdStats();
+unsigned int objectGetBlockingGeneration(int elevation);
+void objectInvalidateBlocking(int elevation);
+void objectBeginIgnoreBlocking(Object* obj);
+void objectEndIgnoreBlocking(Object* obj);
+Object* objectGetBlockingIgnored();
+void objectFlagsChanged(Object* obj);
 bool isExitGridAt(int tile, int elevation);
 
 } // namespace fallout
@@ -1,5 +1,6 @@
 #include "platform_compat.h"
 
+#include <errno.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -24,10 +25,37 @@
 #include <chrono>
 #endif
 
+#ifndef _WIN32
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#endif
+
 #include <SDL.h>
 
 namespace fallout {
 
+#ifndef _WIN32
+// Maps case-folded directory entry name to it's actual name on disk.
+typedef std::unordered_map<std::string, std::string> CompatDirectoryEntries;
+
+static const CompatDirectoryEntries* compat_get_directory_entries(const char* path);
+static bool compat_resolve_path_internal(char* path);
+static void compat_invalidate_directory_cache();
+static bool compat_mode_is_write(const char* mode);
+
+// Contents of directories scanned by [compat_resolve_path] keyed by directory
+// path (as it appears in resolved path prefix).
+//
+// The cache is dropped entirely whenever we create, remove or rename anything
+// on disk via compat functions, or when [compat_fopen] finds a file the cache
+// does not know about. Only xbase probing trusts the cache for misses, so files
+// dropped into a patch directory while the game is running are not noticed
+// there.
+static std::unordered_map<std::string, CompatDirectoryEntries> gCompatDirectoryCache;
+static std::mutex gCompatDirectoryCacheMutex;
+#endif
+
 int compat_stricmp(const char* string1, const char* string2)
 {
     return SDL_strcasecmp(string1, string2);
@@ -211,7 +239,9 @@ int compat_mkdir(const char* path)
 #ifdef _WIN32
     return mkdir(nativePath);
 #else
-    return mkdir(nativePath, 0755);
+    int rc = mkdir(nativePath, 0755);
+    compat_invalidate_directory_cache();
+    return rc;
 #endif
 }
 
@@ -231,8 +261,51 @@ FILE* compat_fopen(const char* path, const char* mode)
     char nativePath[COMPAT_MAX_PATH];
     strcpy(nativePath, path);
     compat_windows_path_to_native(nativePath);
-    compat_resolve_path(nativePath);
-    return fopen(nativePath, mode);
+
+#ifndef _WIN32
+    // The directory cache is only advisory here - the file might have been
+    // created by another process after the directory was scanned.
+    bool known = compat_resolve_path_internal(nativePath);
+#endif
+
+    FILE* stream = fopen(nativePath, mode);
+
+#ifndef _WIN32
+    if (stream != nullptr && (!known || compat_mode_is_write(mode))) {
+        compat_invalidate_directory_cache();
+    }
+#endif
+
+    return stream;
+}
+
+// Same as [compat_fopen], but trusts the directory cache. Only meant for
+// probing directory xbases, where most lookups miss.
+FILE* compat_fopen_probe(const char* path, const char* mode)
+{
+    char nativePath[COMPAT_MAX_PATH];
+    strcpy(nativePath, path);
+    compat_windows_path_to_native(nativePath);
+
+#ifndef _WIN32
+    // Opening for reading cannot succeed if one of the path components is
+    // known to be missing. This makes failed lookups (which are very common
+    // when probing xbases) free.
+    if (!compat_resolve_path_internal(nativePath) && !compat_mode_is_write(mode)) {
+        errno = ENOENT;
+        return nullptr;
+    }
+#endif
+
+    FILE* stream = fopen(nativePath, mode);
+
+#ifndef _WIN32
+    if (stream != nullptr && compat_mode_is_write(mode)) {
+        compat_invalidate_directory_cache();
+    }
+#endif
+
+    return stream;
 }
 
 gzFile compat_gzopen(const char* path, const char* mode)
@@ -241,7 +314,16 @@ gzFile compat_gzopen(const char* path, const char* mode)
     strcpy(nativePath, path);
     compat_windows_path_to_native(nativePath);
     compat_resolve_path(nativePath);
-    return gzopen(nativePath, mode);
+
+    gzFile stream = gzopen(nativePath, mode);
+
+#ifndef _WIN32
+    if (stream != nullptr && compat_mode_is_write(mode)) {
+        compat_invalidate_directory_cache();
+    }
+#endif
+
+    return stream;
 }
 
 char* compat_fgets(char* buffer, int maxCount, FILE* stream)
@@ -280,7 +362,14 @@ int compat_remove(const char* path)
     strcpy(nativePath, path);
     compat_windows_path_to_native(nativePath);
     compat_resolve_path(nativePath);
-    return remove(nativePath);
+
+    int rc = remove(nativePath);
+
+#ifndef _WIN32
+    compat_invalidate_directory_cache();
+#endif
+
+    return rc;
 }
 
 int compat_rename(const char* oldFileName, const char* newFileName)
@@ -295,7 +384,13 @@ int compat_rename(const char* oldFileName, const char* newFileName)
     compat_windows_path_to_native(nativeNewFileName);
     compat_resolve_path(nativeNewFileName);
 
-    return rename(nativeOldFileName, nativeNewFileName);
+    int rc = rename(nativeOldFileName, nativeNewFileName);
+
+#ifndef _WIN32
+    compat_invalidate_directory_cache();
+#endif
+
+    return rc;
 }
 
 void compat_windows_path_to_native(char* path)
@@ -311,20 +406,41 @@ void compat_windows_path_to_native(char* path)
 #endif
 }
 
+// Replaces every component of [path] with the name of matching (case
+// insensitively) entry on disk, leaving the rest of the path as is once a
+// component cannot be found.
+//
+// Directory contents are scanned once and cached, so subsequent lookups in the
+// same directories do not touch the file system.
 void compat_resolve_path(char* path)
 {
 #ifndef _WIN32
+    compat_resolve_path_internal(path);
+#endif
+}
+
+#ifndef _WIN32
+// Resolves [path] (see [compat_resolve_path]).
+//
+// Returns `false` if some path component is definitely missing, that is it
+// was not found in the listing of it's parent directory. Returns `true` if
+// all components were found, or if some directory could not be listed.
+static bool compat_resolve_path_internal(char* path)
+{
+    std::lock_guard<std::mutex> lock(gCompatDirectoryCacheMutex);
+
     char* pch = path;
 
-    DIR* dir;
+    const CompatDirectoryEntries* entries;
     if (pch[0] == '/') {
-        dir = opendir("/");
+        entries = compat_get_directory_entries("/");
         pch++;
     } else {
-        dir = opendir(".");
+        entries = compat_get_directory_entries(".");
     }
 
-    while (dir != nullptr) {
+    std::string name;
+    while (entries != nullptr) {
         char* sep = strchr(pch, '/');
         size_t length;
         if (sep != nullptr) {
@@ -333,37 +449,42 @@ void compat_resolve_path(char* path)
             length = strlen(pch);
         }
 
-        bool found = false;
-
-        struct dirent* entry = readdir(dir);
-        while (entry != nullptr) {
-            if (strlen(entry->d_name) == length && compat_strnicmp(pch, entry->d_name, length) == 0) {
-                strncpy(pch, entry->d_name, length);
-                found = true;
+        if (length == 0) {
+            // Skip empty components (repeated or trailing separators).
+            if (sep == nullptr) {
                 break;
             }
-            entry = readdir(dir);
+
+            pch = sep + 1;
+            continue;
         }
 
-        closedir(dir);
-        dir = nullptr;
+        name.assign(pch, length);
+        for (char& ch : name) {
+            ch = SDL_tolower(ch);
+        }
 
-        if (!found) {
-            break;
+        auto it = entries->find(name);
+        if (it == entries->end()) {
+            return false;
         }
 
+        strncpy(pch, it->second.c_str(), length);
+
         if (sep == nullptr) {
             break;
         }
 
         *sep = '\0';
-        dir = opendir(path);
+        entries = compat_get_directory_entries(path);
         *sep = '/';
 
         pch = sep + 1;
     }
-#endif
+
+    return true;
 }
+#endif
 
 int compat_access(const char* path, int mode)
 {
@@ -390,4 +511,56 @@ long getFileSize(FILE* stream)
     return filesize;
 }
 
+#ifndef _WIN32
+// Returns cached contents of directory at [path], scanning it if needed.
+// Returns `nullptr` if directory cannot be opened.
+//
+// NOTE: Must be called with [gCompatDirectoryCacheMutex] locked.
+static const CompatDirectoryEntries* compat_get_directory_entries(const char* path)
+{
+    auto it = gCompatDirectoryCache.find(path);
+    if (it != gCompatDirectoryCache.end()) {
+        return &(it->second);
+    }
+
+    DIR* dir = opendir(path);
+    if (dir == nullptr) {
+        return nullptr;
+    }
+
+    CompatDirectoryEntries& entries = gCompatDirectoryCache[path];
+
+    std::string name;
+    struct dirent* entry = readdir(dir);
+    while (entry != nullptr) {
+        name = entry->d_name;
+        for (char& ch : name) {
+            ch = SDL_tolower(ch);
+        }
+
+        // Keep the first match in case there are several entries which differ
+        // only by case, just like the original linear scan did.
+        entries.emplace(name, entry->d_name);
+
+        entry = readdir(dir);
+    }
+
+    closedir(dir);
+
+    return &entries;
+}
+
+static void compat_invalidate_directory_cache()
+{
+    std::lock_guard<std::mutex> lock(gCompatDirectoryCacheMutex);
+    gCompatDirectoryCache.clear();
+}
+
+// Returns `true` if file opened with [mode] can be created or modified.
+static bool compat_mode_is_write(const char* mode)
+{
+    return strpbrk(mode, "wa+") != nullptr;
+}
+#endif
+
 } // namespace fallout
@@ -34,6 +34,7 @@ long compat_filelength(int fd);
 int compat_mkdir(const char* path);
 unsigned int compat_timeGetTime();
 FILE* compat_fopen(const char* path, const char* mode);
+FILE* compat_fopen_probe(const char* path, const char* mode);
 gzFile compat_gzopen(const char* path, const char* mode);
 char* compat_fgets(char* buffer, int maxCount, FILE* stream);
 char* compat_gzgets(gzFile stream, char* buffer, int maxCount);
@@ -923,6 +923,7 @@ int _proto_dude_init(const char* path)
 
     if ((gDude->flags & OBJECT_NO_BLOCK) != 0) {
         gDude->flags &= ~OBJECT_NO_BLOCK;
+        objectInvalidateBlocking(gDude->elevation);
     }
 
     critterUpdateDerivedStats(gDude);
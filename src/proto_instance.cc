@@ -1629,6 +1629,7 @@ static int _check_door_state(Object* door, Object* obj2)
         // SFALL: Fix flags on non-door objects.
         if (_obj_is_portal(door)) {
             door->flags &= ~OBJECT_OPEN_DOOR;
+            objectInvalidateBlocking(door->elevation);
         }
 
         _obj_rebuild_all_light();
@@ -1667,6 +1668,7 @@ static int _check_door_state(Object* door, Object* obj2)
         // SFALL: Fix flags on non-door objects.
         if (_obj_is_portal(door)) {
             door->flags |= OBJECT_OPEN_DOOR;
+            objectInvalidateBlocking(door->elevation);
         }
 
         _obj_rebuild_all_light();
@@ -1983,6 +1985,7 @@ int objectLock(Object* object)
         break;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags |= OBJ_LOCKED;
+        objectInvalidateBlocking(object->elevation);
         break;
     default:
         return -1;
@@ -2004,6 +2007,7 @@ int objectUnlock(Object* object)
         return 0;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags &= ~OBJ_LOCKED;
+        objectInvalidateBlocking(object->elevation);
         return 0;
     }
 
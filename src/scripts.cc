@@ -5,6 +5,8 @@
 #include <string.h>
 #include <time.h>
 
+#include <unordered_map>
+
 #include "actions.h"
 #include "animation.h"
 #include "art.h"
@@ -86,6 +88,11 @@ static int scriptListExtentRead(ScriptListExtent* a1, File* stream);
 static int scriptGetNewId(int scriptType);
 static int scriptsRemoveLocalVars(Script* script);
 static int scriptsGetMessageList(int a1, MessageList** out_message_list);
+static void scriptsIndexAdd(Script* script);
+static void scriptsIndexRemove(Script* script);
+static void scriptsIndexMove(int sid, Script* from, Script* to);
+static Script* scriptsIndexFind(int sid);
+static void scriptsIndexRemoveType(int scriptType);
 
 // 0x50D6B8
 static char _Error_2[] = "Error";
@@ -113,6 +120,11 @@ static bool _scr_SpatialsEnabled = true;
 // 0x51C6C0
 static ScriptList gScriptLists[SCRIPT_TYPE_COUNT];
 
+// Maps sid to the script's slot in [gScriptLists]. Must be updated whenever
+// scripts are added, removed or moved between slots. Every slot is indexed,
+// since saves can contain several scripts with the same sid.
+static std::unordered_multimap<int, Script*> gScriptsBySid;
+
 // 0x51C710
 static const char* gScriptsBasePath = "scripts\\";
 
@@ -960,6 +972,7 @@ int scriptsHandleRequests()
                         objectSetLocation(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, nullptr);
                         elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
                         elevatorDoors->data.scenery.door.openFlags &= ~0x01;
+                        objectInvalidateBlocking(elevatorDoors->elevation);
                         _obj_rebuild_all_light();
                     } else {
                         debugPrint("\nWarning: Elevator: Couldn't find old elevator doors!");
@@ -982,6 +995,7 @@ int scriptsHandleRequests()
                     objectSetLocation(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, nullptr);
                     elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
                     elevatorDoors->data.scenery.door.openFlags &= ~0x01;
+                    objectInvalidateBlocking(elevatorDoors->elevation);
                     _obj_rebuild_all_light();
                 } else {
                     debugPrint("\nWarning: Elevator: Couldn't find old elevator doors!");
@@ -1068,6 +1082,7 @@ int _scripts_check_state_in_combat()
                         objectSetLocation(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, nullptr);
                         elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
                         elevatorDoors->data.scenery.door.openFlags &= ~0x01;
+                        objectInvalidateBlocking(elevatorDoors->elevation);
                         _obj_rebuild_all_light();
                     } else {
                         debugPrint("\nWarning: Elevator: Couldn't find old elevator doors!");
@@ -1911,6 +1926,9 @@ int scriptSaveAll(File* stream)
                         memcpy(script, &(lastScriptExtent->scripts[backwardsIndex]), sizeof(Script));
                         memcpy(&(lastScriptExtent->scripts[backwardsIndex]), &temp, sizeof(Script));
 
+                        scriptsIndexMove(temp.sid, script, &(lastScriptExtent->scripts[backwardsIndex]));
+                        scriptsIndexMove(script->sid, &(lastScriptExtent->scripts[backwardsIndex]), script);
+
                         scriptCount++;
                     }
                 }
@@ -2034,6 +2052,8 @@ int scriptLoadAll(File* stream)
     for (int index = 0; index < SCRIPT_TYPE_COUNT; index++) {
         ScriptList* scriptList = &(gScriptLists[index]);
 
+        scriptsIndexRemoveType(index);
+
         int scriptsCount = 0;
         if (fileReadInt32(stream, &scriptsCount) == -1) {
             return -1;
@@ -2064,6 +2084,7 @@ int scriptLoadAll(File* stream)
                 script->target = nullptr;
                 script->program = nullptr;
                 script->flags &= ~SCRIPT_FLAG_0x01;
+                scriptsIndexAdd(script);
             }
 
             extent->next = nullptr;
@@ -2086,6 +2107,7 @@ int scriptLoadAll(File* stream)
                     script->target = nullptr;
                     script->program = nullptr;
                     script->flags &= ~SCRIPT_FLAG_0x01;
+                    scriptsIndexAdd(script);
                 }
 
                 prevExtent->next = extent;
@@ -2120,21 +2142,82 @@ int scriptGetScript(int sid, Script** scriptPtr)
         return -1;
     }
 
-    ScriptList* scriptList = &(gScriptLists[SID_TYPE(sid)]);
-    ScriptListExtent* scriptListExtent = scriptList->head;
+    Script* script = scriptsIndexFind(sid);
+    if (script == nullptr) {
+        return -1;
+    }
 
-    while (scriptListExtent != nullptr) {
-        for (int index = 0; index < scriptListExtent->length; index++) {
-            Script* script = &(scriptListExtent->scripts[index]);
-            if (script->sid == sid) {
-                *scriptPtr = script;
-                return 0;
+    *scriptPtr = script;
+    return 0;
+}
+
+static void scriptsIndexAdd(Script* script)
+{
+    gScriptsBySid.emplace(script->sid, script);
+}
+
+static void scriptsIndexRemove(Script* script)
+{
+    auto range = gScriptsBySid.equal_range(script->sid);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == script) {
+            gScriptsBySid.erase(it);
+            break;
+        }
+    }
+}
+
+// Updates index entry of script with [sid] which has been moved from slot
+// [from] to slot [to].
+static void scriptsIndexMove(int sid, Script* from, Script* to)
+{
+    auto range = gScriptsBySid.equal_range(sid);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == from) {
+            it->second = to;
+            break;
+        }
+    }
+}
+
+// Returns slot of the script with [sid], or `nullptr` if there is no such
+// script. When there are several scripts with the same sid, returns the first
+// one in list order, the same one linear search finds.
+static Script* scriptsIndexFind(int sid)
+{
+    auto range = gScriptsBySid.equal_range(sid);
+    if (range.first == range.second) {
+        return nullptr;
+    }
+
+    auto next = range.first;
+    ++next;
+    if (next == range.second) {
+        return range.first->second;
+    }
+
+    ScriptListExtent* extent = gScriptLists[SID_TYPE(sid)].head;
+    while (extent != nullptr) {
+        for (int index = 0; index < extent->length; index++) {
+            if (extent->scripts[index].sid == sid) {
+                return &(extent->scripts[index]);
             }
         }
-        scriptListExtent = scriptListExtent->next;
+        extent = extent->next;
     }
 
-    return -1;
+    return range.first->second;
+}
+
+static void scriptsIndexRemoveType(int scriptType)
+{
+    for (auto it = gScriptsBySid.begin(); it != gScriptsBySid.end();) {
+        if (SID_TYPE(it->first) == scriptType) {
+            it = gScriptsBySid.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 // 0x4A5ED8
@@ -2223,6 +2306,8 @@ int scriptAdd(int* sidPtr, int scriptType)
 
     scriptListExtent->length++;
 
+    scriptsIndexAdd(scr);
+
     return 0;
 }
 
@@ -2279,20 +2364,17 @@ int scriptRemove(int sid)
 
     ScriptList* scriptList = &(gScriptLists[SID_TYPE(sid)]);
 
+    Script* indexedScript = scriptsIndexFind(sid);
+    if (indexedScript == nullptr) {
+        return -1;
+    }
+
+    // Find extent the script belongs to.
     ScriptListExtent* scriptListExtent = scriptList->head;
-    int index;
     while (scriptListExtent != nullptr) {
-        for (index = 0; index < scriptListExtent->length; index++) {
-            Script* script = &(scriptListExtent->scripts[index]);
-            if (script->sid == sid) {
-                break;
-            }
-        }
-
-        if (index < scriptListExtent->length) {
+        if (indexedScript >= scriptListExtent->scripts && indexedScript < scriptListExtent->scripts + scriptListExtent->length) {
             break;
         }
-
         scriptListExtent = scriptListExtent->next;
     }
 
@@ -2300,6 +2382,7 @@ int scriptRemove(int sid)
         return -1;
     }
 
+    int index = static_cast<int>(indexedScript - scriptListExtent->scripts);
     Script* script = &(scriptListExtent->scripts[index]);
     if ((script->flags & SCRIPT_FLAG_0x02) != 0) {
         if (script->program != nullptr) {
@@ -2319,6 +2402,8 @@ int scriptRemove(int sid)
             debugPrint("\nERROR Removing Timed Events on scr_remove!!\n");
         }
 
+        scriptsIndexRemove(script);
+
         if (scriptListExtent == scriptList->tail && index + 1 == scriptListExtent->length) {
             // Removing last script in tail extent
             scriptListExtent->length -= 1;
@@ -2342,6 +2427,7 @@ int scriptRemove(int sid)
         } else {
             // Relocate last script from tail extent into this script's slot.
             memcpy(&(scriptListExtent->scripts[index]), &(scriptList->tail->scripts[scriptList->tail->length - 1]), sizeof(Script));
+            scriptsIndexMove(scriptListExtent->scripts[index].sid, &(scriptList->tail->scripts[scriptList->tail->length - 1]), &(scriptListExtent->scripts[index]));
 
             // Decrement number of scripts in tail extent.
             scriptList->tail->length -= 1;
@@ -2431,6 +2517,8 @@ int _scr_remove_all_force()
         scriptList->length = 0;
     }
 
+    gScriptsBySid.clear();
+
     gScriptsEnumerationScriptIndex = 0;
     gScriptsEnumerationScriptListExtent = nullptr;
     gScriptsEnumerationElevation = 0;
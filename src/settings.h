@@ -25,6 +25,7 @@ struct SystemSettings {
     bool hashing = true;
     int splash = 0;
     int free_space = 20480;
+    bool mmap_dat = false;
     int times_run = 0;
 };
 
@@ -65,6 +66,7 @@ struct SoundSettings {
     int sndfx_volume = 22281;
     int speech_volume = 22281;
     int cache_size = 448;
+    int pcm_cache_size = 2048;
     std::string music_path1 = "sound\\music\\";
     std::string music_path2 = "sound\\music\\";
 };
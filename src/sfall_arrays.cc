@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <random>
 #include <unordered_map>
@@ -192,6 +193,32 @@ public:
         }
     }
 
+    // Returns hash consistent with `operator==`.
+    size_t hash() const
+    {
+        switch (type) {
+        case ArrayElementType::INT:
+            return std::hash<int>()(value.integerValue);
+        case ArrayElementType::FLOAT:
+            // Make sure 0.0 and -0.0 (which are equal) end up in the same
+            // bucket.
+            return value.floatValue == 0.0f ? 0 : std::hash<float>()(value.floatValue);
+        case ArrayElementType::POINTER:
+            return std::hash<void*>()(value.pointerValue);
+        case ArrayElementType::STRING: {
+            // FNV-1a
+            size_t hash = 2166136261u;
+            for (const unsigned char* ch = (const unsigned char*)value.stringValue; *ch != '\0'; ch++) {
+                hash ^= *ch;
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+        default:
+            return 0;
+        }
+    }
+
     ~ArrayElement()
     {
         if (type == ArrayElementType::STRING) {
@@ -367,45 +394,40 @@ public:
     ProgramValue GetArray(const ProgramValue& key, Program* program)
     {
         auto keyEl = ArrayElement { key, program };
-        auto it = std::find_if(pairs.begin(), pairs.end(), [&keyEl](const KeyValuePair& pair) -> bool {
-            return pair.key == keyEl;
-        });
-
-        if (it == pairs.end()) {
+        int index = FindKey(keyEl, keyEl.hash());
+        if (index == -1) {
             return ProgramValue(0);
         }
 
-        auto index = it - pairs.begin();
         return pairs[index].value.toValue(program);
     }
 
     void SetArray(const ProgramValue& key, const ProgramValue& val, bool allowUnset, Program* program)
     {
         auto keyEl = ArrayElement { key, program };
-        auto it = std::find_if(pairs.begin(), pairs.end(), [&keyEl](const KeyValuePair& pair) -> bool {
-            return pair.key == keyEl;
-        });
+        size_t keyHash = keyEl.hash();
+        int index = FindKey(keyEl, keyHash);
 
-        if (it != pairs.end() && isReadOnly()) {
+        if (index != -1 && isReadOnly()) {
             // don't update value of key
             return;
         }
 
         if (allowUnset && !isReadOnly() && val.isInt() && val.asInt() == 0) {
             // after assigning zero to a key, no need to store it, because "get_array" returns 0 for non-existent keys: try unset
-            if (it != pairs.end()) {
-                pairs.erase(it);
+            if (index != -1) {
+                EraseKey(index, keyHash);
             }
         } else {
-            if (it == pairs.end()) {
+            if (index == -1) {
                 // size check
                 if (size() >= ARRAY_MAX_SIZE) {
                     return;
                 }
 
+                keyIndex.emplace(keyHash, size());
                 pairs.push_back(KeyValuePair { std::move(keyEl), ArrayElement { val, program } });
             } else {
-                auto index = it - pairs.begin();
                 pairs[index].value = ArrayElement { val, program };
             }
         }
@@ -425,9 +447,11 @@ public:
         // only allow to reduce number of elements (adding range of elements is meaningless for maps)
         if (newLen >= 0 && newLen < size()) {
             pairs.resize(newLen);
+            RebuildKeyIndex();
         } else if (newLen < 0) {
             if (newLen < (ARRAY_ACTION_SHUFFLE - 2)) return;
             MapSort(newLen);
+            RebuildKeyIndex();
         }
     }
 
@@ -451,6 +475,50 @@ private:
         ArrayElement value;
     };
 
+    // Returns index of the pair with the specified key, or -1 if there is no
+    // such key.
+    int FindKey(const ArrayElement& keyEl, size_t keyHash) const
+    {
+        auto range = keyIndex.equal_range(keyHash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (pairs[it->second].key == keyEl) {
+                return it->second;
+            }
+        }
+        return -1;
+    }
+
+    // Removes pair at the specified index preserving order of remaining
+    // pairs.
+    void EraseKey(int index, size_t keyHash)
+    {
+        auto range = keyIndex.equal_range(keyHash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == index) {
+                keyIndex.erase(it);
+                break;
+            }
+        }
+
+        pairs.erase(pairs.begin() + index);
+
+        // Pairs past removed one are shifted by one.
+        for (auto& entry : keyIndex) {
+            if (entry.second > index) {
+                entry.second--;
+            }
+        }
+    }
+
+    void RebuildKeyIndex()
+    {
+        keyIndex.clear();
+        keyIndex.reserve(pairs.size());
+        for (int index = 0; index < size(); index++) {
+            keyIndex.emplace(pairs[index].key.hash(), index);
+        }
+    }
+
     void MapSort(int type)
     {
         bool sortByValue = false;
@@ -470,7 +538,12 @@ private:
         }
     }
 
+    // Pairs in insertion order, which is observable by scripts via
+    // `GetArrayKey`.
     std::vector<KeyValuePair> pairs;
+
+    // Maps key hash to index in [pairs].
+    std::unordered_multimap<size_t, int> keyIndex;
 };
 
 struct SfallArraysState {
@@ -116,26 +116,29 @@ void sfall_lists_fill(int type, std::vector<Object*>& objects)
         // CE: Implementation is slightly different. Sfall manually loops thru
         // elevations (3) and hexes (40000) and use |objectFindFirstAtLocation|
         // (originally |obj_find_first_at_tile|) to obtain next object. This
-        // functionality is already implemented in |objectFindFirst| and
-        // |objectFindNext|.
+        // functionality is already implemented in |objectFindFirstAtElevation|
+        // and |objectFindNextAtElevation|, which only visit tiles occupied on
+        // given elevation.
         //
         // As a small optimization |LIST_ALL| is handled separately since there
         // is no need to check object type.
-        if (type == LIST_ALL) {
-            Object* obj = objectFindFirst();
-            while (obj != nullptr) {
-                objects.push_back(obj);
-                obj = objectFindNext();
-            }
-        } else {
-            Object* obj = objectFindFirst();
-            while (obj != nullptr) {
-                int objectType = PID_TYPE(obj->pid);
-                if (objectType < kObjectTypeToListTypeSize
-                    && kObjectTypeToListType[objectType] == type) {
+        for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+            if (type == LIST_ALL) {
+                Object* obj = objectFindFirstAtElevation(elevation);
+                while (obj != nullptr) {
                     objects.push_back(obj);
+                    obj = objectFindNextAtElevation();
+                }
+            } else {
+                Object* obj = objectFindFirstAtElevation(elevation);
+                while (obj != nullptr) {
+                    int objectType = PID_TYPE(obj->pid);
+                    if (objectType < kObjectTypeToListTypeSize
+                        && kObjectTypeToListType[objectType] == type) {
+                        objects.push_back(obj);
+                    }
+                    obj = objectFindNextAtElevation();
                 }
-                obj = objectFindNext();
             }
         }
     }
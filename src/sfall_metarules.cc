@@ -308,6 +308,7 @@ void mf_set_flags(Program* program, int args)
     Object* object = static_cast<Object*>(programStackPopPointer(program));
 
     object->flags = flags;
+    objectFlagsChanged(object);
 
     programStackPushInteger(program, -1);
 }
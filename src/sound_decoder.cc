@@ -11,10 +11,51 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <SDL.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOUND_DECODER_SSE2
+#endif
+
+#include "debug.h"
+
 namespace fallout {
 
 #define SOUND_DECODER_IN_BUFFER_SIZE (512)
 
+// Size of the ring buffer with decoded samples kept ahead of the reader.
+#define SOUND_DECODER_PREFETCH_BUFFER_SIZE (64 * 1024)
+
+// Number of subband columns processed together by untransform routines.
+#define SOUND_DECODER_UNTRANSFORM_TILE (64)
+
+// Max number of bytes background worker decodes in one go.
+#define SOUND_DECODER_PREFETCH_CHUNK_SIZE (8 * 1024)
+
+#define SOUND_DECODER_PREFETCH_MAX (16)
+
+typedef struct SoundDecoderPrefetch {
+    unsigned char* buffer;
+
+    // Position of the first decoded byte not yet consumed by the reader.
+    size_t readPos;
+
+    // Number of decoded bytes available to the reader.
+    size_t length;
+
+    // Set when decoder has no more samples.
+    bool eof;
+
+    // Set while background worker decodes into the free part of the buffer.
+    bool busy;
+
+    // Set when background worker has been stopped while this decoder was
+    // still attached. Remaining samples in the buffer are handed out without
+    // locking, then decoder continues synchronously.
+    bool detached;
+} SoundDecoderPrefetch;
+
 typedef int (*ReadBandFunc)(SoundDecoder* soundDecoder, int offset, int bits);
 
 static bool soundDecoderPrepare(SoundDecoder* soundDecoder, SoundDecoderReadProc* readProc, void* data);
@@ -37,15 +78,18 @@ static int ReadBand_Fmt29(SoundDecoder* soundDecoder, int offset, int bits);
 static bool ReadBands(SoundDecoder* soundDecoder);
 static void untransform_subband0(unsigned char* a1, unsigned char* a2, int a3, int a4);
 static void untransform_subband(unsigned char* a1, unsigned char* a2, int a3, int a4);
+static void untransform_rows(int* rows, int stride, int* s0, int* s1, int count);
 static void untransform_all(SoundDecoder* soundDecoder);
 static bool soundDecoderFill(SoundDecoder* soundDecoder);
 
 static inline void soundDecoderRequireBits(SoundDecoder* soundDecoder, int bits);
 static inline void soundDecoderDropBits(SoundDecoder* soundDecoder, int bits);
 static int ReadBand_Fmt31(SoundDecoder* soundDecoder, int offset, int bits);
-
-// 0x51E328
-static int gSoundDecodersCount = 0;
+static size_t soundDecoderDecodeSamples(SoundDecoder* soundDecoder, void* buffer, size_t size);
+static size_t soundDecoderPrefetchRead(SoundDecoder* soundDecoder, void* buffer, size_t size);
+static size_t soundDecoderPrefetchReadDetached(SoundDecoder* soundDecoder, void* buffer, size_t size);
+static void soundDecoderPrefetchStop(SoundDecoder* soundDecoder);
+static int soundDecoderPrefetchThreadProc(void* data);
 
 // 0x51E330
 static ReadBandFunc _ReadBand_tbl[32] = {
@@ -92,11 +136,26 @@ static unsigned char pack3_3[32];
 // 0x6ADA00
 static unsigned short pack5_3[128];
 
-// 0x6ADB00
-static unsigned char* _AudioDecoder_scale0;
+// Protects prefetch state of all decoders and the decoders list below.
+static SDL_mutex* gSoundDecoderPrefetchMutex = nullptr;
+
+// Signalled when there is work for background worker (new decoder, consumed
+// data, exit request).
+static SDL_cond* gSoundDecoderPrefetchWorkCond = nullptr;
+
+// Signalled when background worker finishes decoding a chunk.
+static SDL_cond* gSoundDecoderPrefetchDataCond = nullptr;
+
+static SDL_Thread* gSoundDecoderPrefetchThread = nullptr;
+static bool gSoundDecoderPrefetchThreadExit = false;
+
+static SoundDecoder* gSoundDecoderPrefetchDecoders[SOUND_DECODER_PREFETCH_MAX];
+static int gSoundDecoderPrefetchDecodersLength = 0;
 
-// 0x6ADB04
-static unsigned char* _AudioDecoder_scale_tbl;
+static unsigned int gSoundDecoderPrefetchUnderruns = 0;
+static double gSoundDecoderPrefetchWaitTotal = 0.0;
+static double gSoundDecoderPrefetchWaitMax = 0.0;
+static unsigned long long gSoundDecoderPrefetchBytesDecoded = 0;
 
 // 0x4D3BB0
 static bool soundDecoderPrepare(SoundDecoder* soundDecoder, SoundDecoderReadProc* readProc, void* data)
@@ -196,7 +255,7 @@ static int ReadBand_Fmt3_16(SoundDecoder* soundDecoder, int offset, int bits)
     int value;
     int v14;
 
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base += (int)(UINT_MAX << (bits - 1));
 
     int* p = (int*)soundDecoder->samples;
@@ -222,7 +281,7 @@ static int ReadBand_Fmt3_16(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D3E90
 static int ReadBand_Fmt17(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -276,7 +335,7 @@ static int ReadBand_Fmt17(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D3F98
 static int ReadBand_Fmt18(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -314,7 +373,7 @@ static int ReadBand_Fmt18(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4068
 static int ReadBand_Fmt19(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base -= 1;
 
     int* p = (int*)soundDecoder->samples;
@@ -352,7 +411,7 @@ static int ReadBand_Fmt19(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4158
 static int ReadBand_Fmt20(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -415,7 +474,7 @@ static int ReadBand_Fmt20(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4254
 static int ReadBand_Fmt21(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -462,7 +521,7 @@ static int ReadBand_Fmt21(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4338
 static int ReadBand_Fmt22(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base -= 2;
 
     int* p = (int*)soundDecoder->samples;
@@ -504,7 +563,7 @@ static int ReadBand_Fmt22(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4434
 static int ReadBand_Fmt23(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -573,7 +632,7 @@ static int ReadBand_Fmt23(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4584
 static int ReadBand_Fmt24(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -627,7 +686,7 @@ static int ReadBand_Fmt24(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4698
 static int ReadBand_Fmt26(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -683,7 +742,7 @@ static int ReadBand_Fmt26(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D47A4
 static int ReadBand_Fmt27(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -723,7 +782,7 @@ static int ReadBand_Fmt27(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4870
 static int ReadBand_Fmt29(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -773,7 +832,7 @@ static bool ReadBands(SoundDecoder* soundDecoder)
 
     v17 = 1 << v9;
 
-    v18 = (unsigned short*)_AudioDecoder_scale0;
+    v18 = (unsigned short*)soundDecoder->scale0;
     v19 = v17;
     v21 = 0;
     while (v19--) {
@@ -781,7 +840,7 @@ static bool ReadBands(SoundDecoder* soundDecoder)
         v21 += v15;
     }
 
-    v18 = (unsigned short*)_AudioDecoder_scale0;
+    v18 = (unsigned short*)soundDecoder->scale0;
     v19 = v17;
     v21 = -v15;
     while (v19--) {
@@ -859,6 +918,38 @@ static void untransform_subband0(unsigned char* a1, unsigned char* a2, int a3, i
 
             v31--;
         }
+    } else if ((a4 & 3) == 0) {
+        // CE: Same recurrence as below, but rows are walked in the outer loop
+        // and a tile of adjacent columns in the inner one (see
+        // `untransform_rows`). Columns are independent from each other, so
+        // the result is identical, while memory is accessed sequentially.
+        short* prev = (short*)a1;
+        int* rows = (int*)a2;
+        int s0[SOUND_DECODER_UNTRANSFORM_TILE];
+        int s1[SOUND_DECODER_UNTRANSFORM_TILE];
+
+        for (int column = 0; column < a3; column += SOUND_DECODER_UNTRANSFORM_TILE) {
+            int count = a3 - column;
+            if (count > SOUND_DECODER_UNTRANSFORM_TILE) {
+                count = SOUND_DECODER_UNTRANSFORM_TILE;
+            }
+
+            for (int index = 0; index < count; index++) {
+                s0[index] = prev[(column + index) * 2];
+                s1[index] = prev[(column + index) * 2 + 1];
+            }
+
+            int* r0 = rows + column;
+            for (int group = a4 >> 2; group != 0; group--) {
+                untransform_rows(r0, a3, s0, s1, count);
+                r0 += a3 * 4;
+            }
+
+            for (int index = 0; index < count; index++) {
+                prev[(column + index) * 2] = s0[index] & 0xFFFF;
+                prev[(column + index) * 2 + 1] = s1[index] & 0xFFFF;
+            }
+        }
     } else {
         int v30 = a4 >> 1;
         int v32 = a3;
@@ -906,18 +997,8 @@ static void untransform_subband0(unsigned char* a1, unsigned char* a2, int a3, i
 // 0x4D4D1C
 static void untransform_subband(unsigned char* a1, unsigned char* a2, int a3, int a4)
 {
-    int v13;
-    int* v14;
     int* v25;
     int* v26;
-    int v15;
-    int v16;
-    int v17;
-
-    int* v18;
-    int v19;
-    int* v20;
-    int* v21;
 
     v26 = (int*)a1;
     v25 = (int*)a2;
@@ -956,41 +1037,88 @@ static void untransform_subband(unsigned char* a1, unsigned char* a2, int a3, in
             v25 += 1;
         }
     } else {
-        int v24 = a3;
+        // CE: Rows are walked in the outer loop and a tile of adjacent
+        // columns in the inner one (see `untransform_subband0`).
+        int s0[SOUND_DECODER_UNTRANSFORM_TILE];
+        int s1[SOUND_DECODER_UNTRANSFORM_TILE];
+
+        for (int column = 0; column < a3; column += SOUND_DECODER_UNTRANSFORM_TILE) {
+            int count = a3 - column;
+            if (count > SOUND_DECODER_UNTRANSFORM_TILE) {
+                count = SOUND_DECODER_UNTRANSFORM_TILE;
+            }
+
+            for (int index = 0; index < count; index++) {
+                s0[index] = v26[(column + index) * 2];
+                s1[index] = v26[(column + index) * 2 + 1];
+            }
 
-        while (v24 != 0) {
-            v13 = a4 >> 2;
-            v14 = v25;
-            v15 = v26[0];
-            v16 = v26[1];
+            int* r0 = v25 + column;
+            for (int group = a4 >> 2; group != 0; group--) {
+                untransform_rows(r0, a3, s0, s1, count);
+                r0 += a3 * 4;
+            }
+
+            for (int index = 0; index < count; index++) {
+                v26[(column + index) * 2] = s0[index];
+                v26[(column + index) * 2 + 1] = s1[index];
+            }
+        }
+    }
+}
 
-            while (--v13 != -1) {
-                v17 = *v14;
-                *v14 += 2 * v16 + v15;
+// Applies one step of inverse transform to four consecutive rows (each
+// [stride] samples apart) for [count] adjacent columns. [s0] and [s1] hold
+// running per-column state.
+static void untransform_rows(int* rows, int stride, int* s0, int* s1, int count)
+{
+    int* r0 = rows;
+    int* r1 = r0 + stride;
+    int* r2 = r1 + stride;
+    int* r3 = r2 + stride;
 
-                v18 = v14 + a3;
-                v19 = *v18;
-                *v18 = 2 * v17 - v16 - v19;
+    int index = 0;
 
-                v20 = v18 + a3;
-                v15 = *v20;
-                *v20 += 2 * v19 + v17;
+#ifdef SOUND_DECODER_SSE2
+    for (; index + 4 <= count; index += 4) {
+        __m128i v20 = _mm_loadu_si128((__m128i*)(s0 + index));
+        __m128i v22 = _mm_loadu_si128((__m128i*)(s1 + index));
 
-                v21 = v20 + a3;
-                v16 = *v21;
-                *v21 = 2 * v15 - v19 - v16;
+        __m128i v24 = _mm_loadu_si128((__m128i*)(r0 + index));
+        _mm_storeu_si128((__m128i*)(r0 + index), _mm_add_epi32(_mm_add_epi32(v24, v20), _mm_slli_epi32(v22, 1)));
 
-                v14 = v21 + a3;
-            }
+        __m128i v26 = _mm_loadu_si128((__m128i*)(r1 + index));
+        _mm_storeu_si128((__m128i*)(r1 + index), _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(v24, 1), v22), v26));
 
-            v26[0] = v15;
-            v26[1] = v16;
+        v20 = _mm_loadu_si128((__m128i*)(r2 + index));
+        _mm_storeu_si128((__m128i*)(r2 + index), _mm_add_epi32(_mm_add_epi32(v20, v24), _mm_slli_epi32(v26, 1)));
 
-            v26 += 2;
-            v25 += 1;
+        v22 = _mm_loadu_si128((__m128i*)(r3 + index));
+        _mm_storeu_si128((__m128i*)(r3 + index), _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(v20, 1), v26), v22));
 
-            v24--;
-        }
+        _mm_storeu_si128((__m128i*)(s0 + index), v20);
+        _mm_storeu_si128((__m128i*)(s1 + index), v22);
+    }
+#endif
+
+    for (; index < count; index++) {
+        int v20 = s0[index];
+        int v22 = s1[index];
+
+        int v24 = r0[index];
+        r0[index] = v24 + 2 * v22 + v20;
+
+        int v26 = r1[index];
+        r1[index] = 2 * v24 - v22 - v26;
+
+        v20 = r2[index];
+        r2[index] = v20 + 2 * v26 + v24;
+
+        v22 = r3[index];
+        r3[index] = 2 * v20 - v26 - v22;
+
+        s0[index] = v20;
+        s1[index] = v22;
     }
 }
 
@@ -1073,6 +1201,15 @@ static bool soundDecoderFill(SoundDecoder* soundDecoder)
 
 // 0x4D4FA0
 size_t soundDecoderDecode(SoundDecoder* soundDecoder, void* buffer, size_t size)
+{
+    if (soundDecoder->prefetch != nullptr) {
+        return soundDecoderPrefetchRead(soundDecoder, buffer, size);
+    }
+
+    return soundDecoderDecodeSamples(soundDecoder, buffer, size);
+}
+
+static size_t soundDecoderDecodeSamples(SoundDecoder* soundDecoder, void* buffer, size_t size)
 {
     unsigned char* dest;
     unsigned char* samp_ptr;
@@ -1113,6 +1250,10 @@ size_t soundDecoderDecode(SoundDecoder* soundDecoder, void* buffer, size_t size)
 // 0x4D5048
 void soundDecoderFree(SoundDecoder* soundDecoder)
 {
+    if (soundDecoder->prefetch != nullptr) {
+        soundDecoderPrefetchStop(soundDecoder);
+    }
+
     if (soundDecoder->bufferIn != nullptr) {
         free(soundDecoder->bufferIn);
     }
@@ -1125,16 +1266,11 @@ void soundDecoderFree(SoundDecoder* soundDecoder)
         free(soundDecoder->samples);
     }
 
-    free(soundDecoder);
-
-    gSoundDecodersCount--;
-
-    if (gSoundDecodersCount == 0) {
-        if (_AudioDecoder_scale_tbl != nullptr) {
-            free(_AudioDecoder_scale_tbl);
-            _AudioDecoder_scale_tbl = nullptr;
-        }
+    if (soundDecoder->scale_tbl != nullptr) {
+        free(soundDecoder->scale_tbl);
     }
+
+    free(soundDecoder);
 }
 
 // 0x4D50A8
@@ -1151,7 +1287,9 @@ SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int*
 
     memset(soundDecoder, 0, sizeof(*soundDecoder));
 
-    gSoundDecodersCount++;
+    // CE: Pack tables are shared between decoders, make sure they are built
+    // on the main thread before any decoder is handed to background worker.
+    init_pack_tables();
 
     if (!soundDecoderPrepare(soundDecoder, readProc, data)) {
         goto L66;
@@ -1231,10 +1369,14 @@ SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int*
 
     soundDecoder->samp_cnt = 0;
 
-    if (gSoundDecodersCount == 1) {
-        _AudioDecoder_scale_tbl = (unsigned char*)malloc(0x20000);
-        _AudioDecoder_scale0 = _AudioDecoder_scale_tbl + 0x10000;
+    // CE: Scale table is rebuilt for every block, so it's owned by decoder
+    // rather than shared between all decoders (like in the original code).
+    // This allows decoders to run on different threads.
+    soundDecoder->scale_tbl = (unsigned char*)malloc(0x20000);
+    if (soundDecoder->scale_tbl == nullptr) {
+        goto L66;
     }
+    soundDecoder->scale0 = soundDecoder->scale_tbl + 0x10000;
 
     *channelsPtr = soundDecoder->channels;
     *sampleRatePtr = soundDecoder->rate;
@@ -1293,4 +1435,321 @@ static int ReadBand_Fmt31(SoundDecoder* soundDecoder, int offset, int bits)
     return 0;
 }
 
+// Moves [soundDecoder] to background worker, which keeps decoding samples
+// ahead into a ring buffer, so that subsequent `soundDecoderDecode` calls
+// only have to copy already decoded data.
+//
+// Returns `false` if prefetching is not available (in which case decoder
+// continues to decode synchronously).
+bool soundDecoderStartPrefetch(SoundDecoder* soundDecoder)
+{
+    if (soundDecoder->prefetch != nullptr) {
+        return true;
+    }
+
+    if (gSoundDecoderPrefetchMutex == nullptr) {
+        gSoundDecoderPrefetchMutex = SDL_CreateMutex();
+        gSoundDecoderPrefetchWorkCond = SDL_CreateCond();
+        gSoundDecoderPrefetchDataCond = SDL_CreateCond();
+        if (gSoundDecoderPrefetchMutex == nullptr || gSoundDecoderPrefetchWorkCond == nullptr || gSoundDecoderPrefetchDataCond == nullptr) {
+            soundDecoderPrefetchExit();
+            return false;
+        }
+    }
+
+    if (gSoundDecoderPrefetchThread == nullptr) {
+        gSoundDecoderPrefetchThreadExit = false;
+        gSoundDecoderPrefetchThread = SDL_CreateThread(soundDecoderPrefetchThreadProc, "SoundDecoder", nullptr);
+        if (gSoundDecoderPrefetchThread == nullptr) {
+            return false;
+        }
+    }
+
+    SoundDecoderPrefetch* prefetch = (SoundDecoderPrefetch*)malloc(sizeof(*prefetch));
+    if (prefetch == nullptr) {
+        return false;
+    }
+
+    prefetch->buffer = (unsigned char*)malloc(SOUND_DECODER_PREFETCH_BUFFER_SIZE);
+    if (prefetch->buffer == nullptr) {
+        free(prefetch);
+        return false;
+    }
+
+    prefetch->readPos = 0;
+    prefetch->length = 0;
+    prefetch->eof = false;
+    prefetch->busy = false;
+    prefetch->detached = false;
+
+    SDL_LockMutex(gSoundDecoderPrefetchMutex);
+
+    if (gSoundDecoderPrefetchDecodersLength == SOUND_DECODER_PREFETCH_MAX) {
+        SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+        free(prefetch->buffer);
+        free(prefetch);
+        return false;
+    }
+
+    // Decoder can be given to worker only in it's initial state (there are
+    // no partially consumed samples).
+    soundDecoder->prefetch = prefetch;
+    gSoundDecoderPrefetchDecoders[gSoundDecoderPrefetchDecodersLength++] = soundDecoder;
+
+    SDL_CondSignal(gSoundDecoderPrefetchWorkCond);
+    SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+    return true;
+}
+
+// Stops background worker. Decoders still attached to it keep samples
+// decoded so far and then continue to decode synchronously.
+void soundDecoderPrefetchExit()
+{
+    if (gSoundDecoderPrefetchThread != nullptr) {
+        SDL_LockMutex(gSoundDecoderPrefetchMutex);
+        gSoundDecoderPrefetchThreadExit = true;
+        SDL_CondSignal(gSoundDecoderPrefetchWorkCond);
+        SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+        SDL_WaitThread(gSoundDecoderPrefetchThread, nullptr);
+        gSoundDecoderPrefetchThread = nullptr;
+    }
+
+    // Worker is gone, so no decoder is busy and the list can be touched
+    // without locking.
+    for (int index = 0; index < gSoundDecoderPrefetchDecodersLength; index++) {
+        gSoundDecoderPrefetchDecoders[index]->prefetch->detached = true;
+    }
+    gSoundDecoderPrefetchDecodersLength = 0;
+
+    if (gSoundDecoderPrefetchDataCond != nullptr) {
+        SDL_DestroyCond(gSoundDecoderPrefetchDataCond);
+        gSoundDecoderPrefetchDataCond = nullptr;
+    }
+
+    if (gSoundDecoderPrefetchWorkCond != nullptr) {
+        SDL_DestroyCond(gSoundDecoderPrefetchWorkCond);
+        gSoundDecoderPrefetchWorkCond = nullptr;
+    }
+
+    if (gSoundDecoderPrefetchMutex != nullptr) {
+        SDL_DestroyMutex(gSoundDecoderPrefetchMutex);
+        gSoundDecoderPrefetchMutex = nullptr;
+    }
+}
+
+void soundDecoderPrintStats()
+{
+    debugPrint("Sound decoder prefetch: %llu bytes decoded ahead, %u underruns, waited %.2f ms total, %.2f ms max\n",
+        gSoundDecoderPrefetchBytesDecoded,
+        gSoundDecoderPrefetchUnderruns,
+        gSoundDecoderPrefetchWaitTotal,
+        gSoundDecoderPrefetchWaitMax);
+}
+
+// Copies decoded samples from ring buffer of [soundDecoder]. Blocks until
+// background worker decodes more samples when ring buffer is exhausted.
+static size_t soundDecoderPrefetchRead(SoundDecoder* soundDecoder, void* buffer, size_t size)
+{
+    SoundDecoderPrefetch* prefetch = soundDecoder->prefetch;
+    if (prefetch->detached) {
+        return soundDecoderPrefetchReadDetached(soundDecoder, buffer, size);
+    }
+
+    unsigned char* dest = (unsigned char*)buffer;
+    size_t bytesRead = 0;
+
+    SDL_LockMutex(gSoundDecoderPrefetchMutex);
+
+    while (bytesRead < size) {
+        if (prefetch->length == 0) {
+            if (prefetch->eof) {
+                break;
+            }
+
+            gSoundDecoderPrefetchUnderruns++;
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            SDL_CondSignal(gSoundDecoderPrefetchWorkCond);
+            while (prefetch->length == 0 && !prefetch->eof) {
+                SDL_CondWait(gSoundDecoderPrefetchDataCond, gSoundDecoderPrefetchMutex);
+            }
+
+            double wait = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+            gSoundDecoderPrefetchWaitTotal += wait;
+            if (wait > gSoundDecoderPrefetchWaitMax) {
+                gSoundDecoderPrefetchWaitMax = wait;
+            }
+            continue;
+        }
+
+        size_t chunkSize = size - bytesRead;
+        if (chunkSize > prefetch->length) {
+            chunkSize = prefetch->length;
+        }
+
+        if (chunkSize > SOUND_DECODER_PREFETCH_BUFFER_SIZE - prefetch->readPos) {
+            chunkSize = SOUND_DECODER_PREFETCH_BUFFER_SIZE - prefetch->readPos;
+        }
+
+        memcpy(dest + bytesRead, prefetch->buffer + prefetch->readPos, chunkSize);
+        bytesRead += chunkSize;
+
+        prefetch->readPos = (prefetch->readPos + chunkSize) % SOUND_DECODER_PREFETCH_BUFFER_SIZE;
+        prefetch->length -= chunkSize;
+    }
+
+    // Let worker refill consumed space.
+    SDL_CondSignal(gSoundDecoderPrefetchWorkCond);
+    SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+    return bytesRead;
+}
+
+// Same as [soundDecoderPrefetchRead] for decoder detached from stopped worker.
+// Once the buffer is drained the decoder is switched back to synchronous
+// decoding.
+static size_t soundDecoderPrefetchReadDetached(SoundDecoder* soundDecoder, void* buffer, size_t size)
+{
+    SoundDecoderPrefetch* prefetch = soundDecoder->prefetch;
+    unsigned char* dest = (unsigned char*)buffer;
+    size_t bytesRead = 0;
+
+    while (bytesRead < size && prefetch->length != 0) {
+        size_t chunkSize = size - bytesRead;
+        if (chunkSize > prefetch->length) {
+            chunkSize = prefetch->length;
+        }
+
+        if (chunkSize > SOUND_DECODER_PREFETCH_BUFFER_SIZE - prefetch->readPos) {
+            chunkSize = SOUND_DECODER_PREFETCH_BUFFER_SIZE - prefetch->readPos;
+        }
+
+        memcpy(dest + bytesRead, prefetch->buffer + prefetch->readPos, chunkSize);
+        bytesRead += chunkSize;
+
+        prefetch->readPos = (prefetch->readPos + chunkSize) % SOUND_DECODER_PREFETCH_BUFFER_SIZE;
+        prefetch->length -= chunkSize;
+    }
+
+    if (prefetch->length == 0) {
+        soundDecoder->prefetch = nullptr;
+        free(prefetch->buffer);
+        free(prefetch);
+
+        if (bytesRead < size) {
+            bytesRead += soundDecoderDecodeSamples(soundDecoder, dest + bytesRead, size - bytesRead);
+        }
+    }
+
+    return bytesRead;
+}
+
+// Takes [soundDecoder] away from background worker. Waits for the worker to
+// finish decoding if it's currently busy with this decoder.
+static void soundDecoderPrefetchStop(SoundDecoder* soundDecoder)
+{
+    SoundDecoderPrefetch* prefetch = soundDecoder->prefetch;
+
+    // Worker is gone and decoder is no longer in its list.
+    if (prefetch->detached) {
+        soundDecoder->prefetch = nullptr;
+        free(prefetch->buffer);
+        free(prefetch);
+        return;
+    }
+
+    SDL_LockMutex(gSoundDecoderPrefetchMutex);
+
+    while (prefetch->busy) {
+        SDL_CondWait(gSoundDecoderPrefetchDataCond, gSoundDecoderPrefetchMutex);
+    }
+
+    for (int index = 0; index < gSoundDecoderPrefetchDecodersLength; index++) {
+        if (gSoundDecoderPrefetchDecoders[index] == soundDecoder) {
+            gSoundDecoderPrefetchDecodersLength--;
+            gSoundDecoderPrefetchDecoders[index] = gSoundDecoderPrefetchDecoders[gSoundDecoderPrefetchDecodersLength];
+            break;
+        }
+    }
+
+    soundDecoder->prefetch = nullptr;
+
+    SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+    free(prefetch->buffer);
+    free(prefetch);
+}
+
+static int soundDecoderPrefetchThreadProc(void* data)
+{
+    // Samples are decoded here and then copied into ring buffer (which might
+    // wrap).
+    static unsigned char chunk[SOUND_DECODER_PREFETCH_CHUNK_SIZE];
+
+    SDL_LockMutex(gSoundDecoderPrefetchMutex);
+
+    while (!gSoundDecoderPrefetchThreadExit) {
+        // Pick decoder with the least amount of decoded data, it's the one
+        // most likely to underrun.
+        SoundDecoder* soundDecoder = nullptr;
+        for (int index = 0; index < gSoundDecoderPrefetchDecodersLength; index++) {
+            SoundDecoder* candidate = gSoundDecoderPrefetchDecoders[index];
+            SoundDecoderPrefetch* prefetch = candidate->prefetch;
+            if (!prefetch->eof && prefetch->length + 2 <= SOUND_DECODER_PREFETCH_BUFFER_SIZE) {
+                if (soundDecoder == nullptr || prefetch->length < soundDecoder->prefetch->length) {
+                    soundDecoder = candidate;
+                }
+            }
+        }
+
+        if (soundDecoder == nullptr) {
+            SDL_CondWait(gSoundDecoderPrefetchWorkCond, gSoundDecoderPrefetchMutex);
+            continue;
+        }
+
+        SoundDecoderPrefetch* prefetch = soundDecoder->prefetch;
+
+        // Samples are 16-bit, keep chunk size even.
+        size_t chunkSize = SOUND_DECODER_PREFETCH_BUFFER_SIZE - prefetch->length;
+        if (chunkSize > SOUND_DECODER_PREFETCH_CHUNK_SIZE) {
+            chunkSize = SOUND_DECODER_PREFETCH_CHUNK_SIZE;
+        }
+        chunkSize &= ~1;
+
+        // Decode without lock, decoder state is only touched by worker while
+        // it's marked busy.
+        prefetch->busy = true;
+        SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+        size_t bytesDecoded = soundDecoderDecodeSamples(soundDecoder, chunk, chunkSize);
+
+        SDL_LockMutex(gSoundDecoderPrefetchMutex);
+        prefetch->busy = false;
+
+        size_t writePos = (prefetch->readPos + prefetch->length) % SOUND_DECODER_PREFETCH_BUFFER_SIZE;
+        size_t bytesToEnd = SOUND_DECODER_PREFETCH_BUFFER_SIZE - writePos;
+        if (bytesDecoded > bytesToEnd) {
+            memcpy(prefetch->buffer + writePos, chunk, bytesToEnd);
+            memcpy(prefetch->buffer, chunk + bytesToEnd, bytesDecoded - bytesToEnd);
+        } else {
+            memcpy(prefetch->buffer + writePos, chunk, bytesDecoded);
+        }
+
+        prefetch->length += bytesDecoded;
+        if (bytesDecoded < chunkSize) {
+            prefetch->eof = true;
+        }
+
+        gSoundDecoderPrefetchBytesDecoded += bytesDecoded;
+
+        SDL_CondBroadcast(gSoundDecoderPrefetchDataCond);
+    }
+
+    SDL_UnlockMutex(gSoundDecoderPrefetchMutex);
+
+    return 0;
+}
+
 } // namespace fallout
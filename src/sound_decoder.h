@@ -7,6 +7,8 @@ namespace fallout {
 
 typedef int(SoundDecoderReadProc)(void* data, void* buffer, unsigned int size);
 
+typedef struct SoundDecoderPrefetch SoundDecoderPrefetch;
+
 typedef struct SoundDecoder {
     SoundDecoderReadProc* readProc;
     void* data;
@@ -37,11 +39,17 @@ typedef struct SoundDecoder {
     int file_cnt;
     unsigned char* samp_ptr;
     int samp_cnt;
+    unsigned char* scale_tbl;
+    unsigned char* scale0;
+    SoundDecoderPrefetch* prefetch;
 } SoundDecoder;
 
 size_t soundDecoderDecode(SoundDecoder* soundDecoder, void* buffer, size_t size);
 void soundDecoderFree(SoundDecoder* soundDecoder);
 SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int* channelsPtr, int* sampleRatePtr, int* sampleCountPtr);
+bool soundDecoderStartPrefetch(SoundDecoder* soundDecoder);
+void soundDecoderPrefetchExit();
+void soundDecoderPrintStats();
 
 } // namespace fallout
 
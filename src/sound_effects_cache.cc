@@ -8,6 +8,7 @@
 
 #include "cache.h"
 #include "db.h"
+#include "debug.h"
 #include "memory.h"
 #include "settings.h"
 #include "sound_decoder.h"
@@ -17,6 +18,23 @@ namespace fallout {
 
 #define SOUND_EFFECTS_CACHE_MIN_SIZE (0x40000)
 
+// The maximum number of decoded sound effects kept in PCM cache.
+#define SOUND_EFFECTS_PCM_CACHE_CAPACITY (64)
+
+// Decoded sound effect.
+typedef struct SoundEffectPcm {
+    int tag;
+    unsigned char* data;
+    int size;
+
+    // Number of open sound effects reading from [data]. Referenced entries
+    // are never evicted.
+    int refCount;
+
+    // Access stamp used to find least recently used entry.
+    unsigned int lastUsed;
+} SoundEffectPcm;
+
 typedef struct SoundEffect {
     // NOTE: This field is only 1 byte, likely unsigned char. It always uses
     // cmp for checking implying it's not bitwise flags. Therefore it's better
@@ -30,6 +48,9 @@ typedef struct SoundEffect {
     int position;
     int dataPosition;
     unsigned char* data;
+
+    // Decoded data of this sound effect (if it's in PCM cache).
+    SoundEffectPcm* pcm;
 } SoundEffect;
 
 static int soundEffectsCacheGetFileSizeImpl(int tag, int* sizePtr);
@@ -41,6 +62,9 @@ static int soundEffectsCreate(int* handlePtr, int id, void* data, CacheEntry* ca
 static bool soundEffectsIsValidHandle(int a1);
 static int soundEffectsCacheFileReadCompressed(int handle, void* buf, unsigned int size);
 static int soundEffectsCacheSoundDecoderReadHandler(void* data, void* buf, unsigned int size);
+static SoundEffectPcm* soundEffectsPcmCacheAcquire(int handle);
+static bool soundEffectsPcmCacheEvict();
+static void soundEffectsPcmCacheFlush();
 
 // 0x50DE04
 static const char* off_50DE04 = "";
@@ -69,6 +93,17 @@ static SoundEffect* gSoundEffects = nullptr;
 // 0x51C8E8
 static int _sfxc_files_open = 0;
 
+// Decoded PCM cache for compressed sound effects. Keeps recently played
+// effects decoded, so that replays (as well as streaming reads) do not need
+// to run decoder over and over again.
+static SoundEffectPcm gSoundEffectsPcmCache[SOUND_EFFECTS_PCM_CACHE_CAPACITY];
+static int gSoundEffectsPcmCacheSize = 0;
+static int gSoundEffectsPcmCacheMaxSize = 0;
+static unsigned int gSoundEffectsPcmCacheClock = 0;
+static unsigned int gSoundEffectsPcmCacheHits = 0;
+static unsigned int gSoundEffectsPcmCacheMisses = 0;
+static unsigned int gSoundEffectsPcmCacheEvictions = 0;
+
 // sfxc_init
 // 0x4A8FC0
 int soundEffectsCacheInit(int cacheSize, const char* effectsPath)
@@ -115,6 +150,8 @@ int soundEffectsCacheInit(int cacheSize, const char* effectsPath)
         return -1;
     }
 
+    gSoundEffectsPcmCacheMaxSize = settings.sound.pcm_cache_size << 10;
+
     gSoundEffectsCacheInitialized = true;
 
     return 0;
@@ -124,12 +161,22 @@ int soundEffectsCacheInit(int cacheSize, const char* effectsPath)
 void soundEffectsCacheExit()
 {
     if (gSoundEffectsCacheInitialized) {
+        char stats[256];
+        soundEffectsCachePrintStats(stats, sizeof(stats));
+        debugPrint("%s", stats);
+
         cacheFree(gSoundEffectsCache);
         internal_free(gSoundEffectsCache);
         gSoundEffectsCache = nullptr;
 
         soundEffectsCacheFreeHandles();
 
+        // Handles are gone, so are references to decoded data.
+        for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+            gSoundEffectsPcmCache[index].refCount = 0;
+        }
+        soundEffectsPcmCacheFlush();
+
         soundEffectsListExit();
 
         internal_free(gSoundEffectsCacheEffectsPath);
@@ -149,7 +196,32 @@ void soundEffectsCacheFlush()
 {
     if (gSoundEffectsCacheInitialized) {
         cacheFlush(gSoundEffectsCache);
+        soundEffectsPcmCacheFlush();
+    }
+}
+
+bool soundEffectsCachePrintStats(char* dest, size_t size)
+{
+    if (dest == nullptr) {
+        return false;
+    }
+
+    int count = 0;
+    for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+        if (gSoundEffectsPcmCache[index].data != nullptr) {
+            count++;
+        }
     }
+
+    snprintf(dest, size, "Sound effects PCM cache: %d entries, %d/%d bytes, %u hits, %u misses, %u evictions\n",
+        count,
+        gSoundEffectsPcmCacheSize,
+        gSoundEffectsPcmCacheMaxSize,
+        gSoundEffectsPcmCacheHits,
+        gSoundEffectsPcmCacheMisses,
+        gSoundEffectsPcmCacheEvictions);
+
+    return true;
 }
 
 // sfxc_cached_open
@@ -202,6 +274,11 @@ int soundEffectsCacheFileClose(int handle)
         return -1;
     }
 
+    if (soundEffect->pcm != nullptr) {
+        soundEffect->pcm->refCount--;
+        soundEffect->pcm = nullptr;
+    }
+
     // FIXME: This is check is redundant and implemented incorrectly. There is
     // an overflow when handle == SOUND_EFFECTS_MAX_COUNT, but thanks to
     // [soundEffectsIsValidHandle] handle will always be less than
@@ -242,8 +319,18 @@ int soundEffectsCacheFileRead(int handle, void* buf, unsigned int size)
         memcpy(buf, soundEffect->data + soundEffect->position, bytesToRead);
         break;
     case 1:
-        if (soundEffectsCacheFileReadCompressed(handle, buf, bytesToRead) != 0) {
-            return -1;
+        // CE: Serve reads from decoded PCM cache when possible, falling back
+        // to decoding from the beginning of the effect.
+        if (soundEffect->pcm == nullptr) {
+            soundEffect->pcm = soundEffectsPcmCacheAcquire(handle);
+        }
+
+        if (soundEffect->pcm != nullptr) {
+            memcpy(buf, soundEffect->pcm->data + soundEffect->position, bytesToRead);
+        } else {
+            if (soundEffectsCacheFileReadCompressed(handle, buf, bytesToRead) != 0) {
+                return -1;
+            }
         }
         break;
     default:
@@ -437,6 +524,7 @@ static int soundEffectsCreate(int* handlePtr, int tag, void* data, CacheEntry* c
     soundEffect->dataPosition = 0;
 
     soundEffect->data = (unsigned char*)data;
+    soundEffect->pcm = nullptr;
 
     *handlePtr = index;
 
@@ -526,4 +614,130 @@ static int soundEffectsCacheSoundDecoderReadHandler(void* data, void* buf, unsig
     return bytesToRead;
 }
 
+// Returns decoded data of the sound effect specified by [handle] (referenced
+// on behalf of this sound effect), decoding and caching it if needed.
+//
+// Returns `nullptr` when PCM cache is disabled, the effect does not fit, or
+// decoding fails.
+static SoundEffectPcm* soundEffectsPcmCacheAcquire(int handle)
+{
+    SoundEffect* soundEffect = &(gSoundEffects[handle]);
+
+    if (soundEffect->dataSize <= 0 || soundEffect->dataSize > gSoundEffectsPcmCacheMaxSize) {
+        return nullptr;
+    }
+
+    gSoundEffectsPcmCacheClock++;
+
+    SoundEffectPcm* freeEntry = nullptr;
+    for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+        SoundEffectPcm* entry = &(gSoundEffectsPcmCache[index]);
+        if (entry->data == nullptr) {
+            if (freeEntry == nullptr) {
+                freeEntry = entry;
+            }
+        } else if (entry->tag == soundEffect->tag) {
+            entry->refCount++;
+            entry->lastUsed = gSoundEffectsPcmCacheClock;
+            gSoundEffectsPcmCacheHits++;
+            return entry;
+        }
+    }
+
+    gSoundEffectsPcmCacheMisses++;
+
+    while (gSoundEffectsPcmCacheSize + soundEffect->dataSize > gSoundEffectsPcmCacheMaxSize) {
+        if (!soundEffectsPcmCacheEvict()) {
+            return nullptr;
+        }
+    }
+
+    if (freeEntry == nullptr) {
+        if (!soundEffectsPcmCacheEvict()) {
+            return nullptr;
+        }
+
+        for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+            if (gSoundEffectsPcmCache[index].data == nullptr) {
+                freeEntry = &(gSoundEffectsPcmCache[index]);
+                break;
+            }
+        }
+    }
+
+    unsigned char* data = (unsigned char*)internal_malloc(soundEffect->dataSize);
+    if (data == nullptr) {
+        return nullptr;
+    }
+
+    soundEffect->dataPosition = 0;
+
+    int channels;
+    int sampleRate;
+    int sampleCount;
+    SoundDecoder* soundDecoder = soundDecoderInit(soundEffectsCacheSoundDecoderReadHandler, &handle, &channels, &sampleRate, &sampleCount);
+    if (soundDecoder == nullptr) {
+        internal_free(data);
+        return nullptr;
+    }
+
+    size_t bytesRead = soundDecoderDecode(soundDecoder, data, soundEffect->dataSize);
+    soundDecoderFree(soundDecoder);
+
+    if ((int)bytesRead != soundEffect->dataSize) {
+        internal_free(data);
+        return nullptr;
+    }
+
+    freeEntry->tag = soundEffect->tag;
+    freeEntry->data = data;
+    freeEntry->size = soundEffect->dataSize;
+    freeEntry->refCount = 1;
+    freeEntry->lastUsed = gSoundEffectsPcmCacheClock;
+
+    gSoundEffectsPcmCacheSize += freeEntry->size;
+
+    return freeEntry;
+}
+
+// Frees least recently used PCM cache entry which is not referenced by any
+// open sound effect.
+static bool soundEffectsPcmCacheEvict()
+{
+    SoundEffectPcm* victim = nullptr;
+    for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+        SoundEffectPcm* entry = &(gSoundEffectsPcmCache[index]);
+        if (entry->data != nullptr && entry->refCount == 0) {
+            if (victim == nullptr || entry->lastUsed < victim->lastUsed) {
+                victim = entry;
+            }
+        }
+    }
+
+    if (victim == nullptr) {
+        return false;
+    }
+
+    internal_free(victim->data);
+    victim->data = nullptr;
+
+    gSoundEffectsPcmCacheSize -= victim->size;
+    gSoundEffectsPcmCacheEvictions++;
+
+    return true;
+}
+
+// Frees all PCM cache entries which are not referenced by open sound effects.
+static void soundEffectsPcmCacheFlush()
+{
+    for (int index = 0; index < SOUND_EFFECTS_PCM_CACHE_CAPACITY; index++) {
+        SoundEffectPcm* entry = &(gSoundEffectsPcmCache[index]);
+        if (entry->data != nullptr && entry->refCount == 0) {
+            internal_free(entry->data);
+            entry->data = nullptr;
+            gSoundEffectsPcmCacheSize -= entry->size;
+        }
+    }
+}
+
 } // namespace fallout
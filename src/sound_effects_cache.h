@@ -1,6 +1,8 @@
 #ifndef SOUND_EFFECTS_CACHE_H
 #define SOUND_EFFECTS_CACHE_H
 
+#include <stddef.h>
+
 namespace fallout {
 
 // The maximum number of sound effects that can be loaded and played
@@ -11,6 +13,7 @@ int soundEffectsCacheInit(int cache_size, const char* effectsPath);
 void soundEffectsCacheExit();
 int soundEffectsCacheInitialized();
 void soundEffectsCacheFlush();
+bool soundEffectsCachePrintStats(char* dest, size_t size);
 int soundEffectsCacheFileOpen(const char* fname, int* sampleRate);
 int soundEffectsCacheFileClose(int handle);
 int soundEffectsCacheFileRead(int handle, void* buf, unsigned int size);
@@ -6,6 +6,7 @@
 #include <SDL.h>
 
 #include "config.h"
+#include "debug.h"
 #include "draw.h"
 #include "interface.h"
 #include "memory.h"
@@ -21,6 +22,8 @@ namespace fallout {
 
 static bool createRenderer(int width, int height);
 static void destroyRenderer();
+static void renderMarkDirty(int x, int y, int width, int height);
+static void renderMarkAllDirty();
 
 bool gStretchEnabled = false;
 static bool gPreserveAspect = true; // used internally for stretching
@@ -48,6 +51,24 @@ SDL_Surface* gSdlTextureSurface = nullptr;
 // TODO: Remove once migration to update-render cycle is completed.
 FpsLimiter sharedFpsLimiter;
 
+// Area of [gSdlTextureSurface] changed since last [renderPresent]. Only this
+// area is uploaded to [gSdlTexture], and presenting is skipped altogether when
+// it's empty and nothing else requires redraw.
+static SDL_Rect gRenderDirtyRect = { 0, 0, 0, 0 };
+
+// Set when [gSdlTexture] or renderer contents cannot be trusted (new renderer,
+// device reset, etc.), so that next [renderPresent] uploads everything.
+static bool gRenderNeedsRedraw = true;
+
+// Source and destination rects used by last [renderPresent]. When they change
+// (stretching toggled, window resized) the whole frame is presented again.
+static SDL_Rect gRenderLastSrcRect = { 0, 0, 0, 0 };
+static SDL_Rect gRenderLastDestRect = { 0, 0, 0, 0 };
+
+static unsigned long long gRenderUploadedBytes = 0;
+static unsigned int gRenderPresentedFrames = 0;
+static unsigned int gRenderSkippedFrames = 0;
+
 // 0x4CAD08
 int _init_mode_320_200()
 {
@@ -266,6 +287,7 @@ void directDrawSetPaletteInRange(unsigned char* palette, int start, int count)
 
         SDL_SetPaletteColors(gSdlSurface->format->palette, colors, start, count);
         SDL_BlitSurface(gSdlSurface, nullptr, gSdlTextureSurface, nullptr);
+        renderMarkAllDirty();
     }
 }
 
@@ -284,6 +306,7 @@ void directDrawSetPalette(unsigned char* palette)
 
         SDL_SetPaletteColors(gSdlSurface->format->palette, colors, 0, 256);
         SDL_BlitSurface(gSdlSurface, nullptr, gSdlTextureSurface, nullptr);
+        renderMarkAllDirty();
     }
 }
 
@@ -322,6 +345,8 @@ void _GNW95_ShowRect(unsigned char* src, int srcPitch, int _, int srcX, int srcY
     destRect.x = destX;
     destRect.y = destY;
     SDL_BlitSurface(gSdlSurface, &srcRect, gSdlTextureSurface, &destRect);
+
+    renderMarkDirty(destX, destY, srcWidth, srcHeight);
 }
 
 // Clears drawing surface.
@@ -340,6 +365,7 @@ void _GNW95_zero_vid_mem()
     }
 
     SDL_BlitSurface(gSdlSurface, nullptr, gSdlTextureSurface, nullptr);
+    renderMarkAllDirty();
 }
 
 int screenGetWidth()
@@ -400,6 +426,8 @@ static bool createRenderer(int width, int height)
         return false;
     }
 
+    renderInvalidate();
+
     return true;
 }
 
@@ -529,10 +557,6 @@ void renderPresent()
             destRect = { 0, 0, renderW, renderH };
         }
 
-        SDL_UpdateTexture(gSdlTexture, &srcRect,
-            (uint8_t*)gSdlTextureSurface->pixels + contentOffsetY * gSdlTextureSurface->pitch + contentOffsetX * 4,
-            gSdlTextureSurface->pitch);
-
     } else {
         // Stretching disabled — display original size scaled for DPI, centered
 
@@ -544,12 +568,39 @@ void renderPresent()
             (int)(gSdlTextureSurface->w * scaleX),
             (int)(gSdlTextureSurface->h * scaleY)
         };
+    }
 
-        SDL_UpdateTexture(gSdlTexture, nullptr,
-            gSdlTextureSurface->pixels,
-            gSdlTextureSurface->pitch);
+    // CE: Only upload part of the frame that changed since last present, and
+    // skip presenting when nothing changed at all.
+    if (!SDL_RectEquals(&srcRect, &gRenderLastSrcRect) || !SDL_RectEquals(&destRect, &gRenderLastDestRect)) {
+        // Parts of [srcRect] might not have been uploaded while they were
+        // outside of previous one.
+        gRenderNeedsRedraw = true;
     }
 
+    SDL_Rect uploadRect;
+    if (gRenderNeedsRedraw) {
+        uploadRect = srcRect;
+    } else if (SDL_RectEmpty(&gRenderDirtyRect)
+        || !SDL_IntersectRect(&gRenderDirtyRect, &srcRect, &uploadRect)) {
+        gRenderSkippedFrames++;
+        gRenderDirtyRect = { 0, 0, 0, 0 };
+        return;
+    }
+
+    int bytesPerPixel = gSdlTextureSurface->format->BytesPerPixel;
+    SDL_UpdateTexture(gSdlTexture, &uploadRect,
+        (uint8_t*)gSdlTextureSurface->pixels + uploadRect.y * gSdlTextureSurface->pitch + uploadRect.x * bytesPerPixel,
+        gSdlTextureSurface->pitch);
+
+    gRenderUploadedBytes += (unsigned long long)uploadRect.w * uploadRect.h * bytesPerPixel;
+    gRenderPresentedFrames++;
+
+    gRenderDirtyRect = { 0, 0, 0, 0 };
+    gRenderNeedsRedraw = false;
+    gRenderLastSrcRect = srcRect;
+    gRenderLastDestRect = destRect;
+
     SDL_SetRenderDrawColor(gSdlRenderer, 0, 0, 255, 255);
     SDL_RenderClear(gSdlRenderer);
 
@@ -557,4 +608,45 @@ void renderPresent()
     SDL_RenderPresent(gSdlRenderer);
 }
 
+// Forces next [renderPresent] to upload and present the whole frame.
+void renderInvalidate()
+{
+    renderMarkAllDirty();
+    gRenderNeedsRedraw = true;
+}
+
+void renderPrintStats()
+{
+    unsigned long long averageBytes = gRenderPresentedFrames != 0
+        ? gRenderUploadedBytes / gRenderPresentedFrames
+        : 0;
+
+    debugPrint("Render: presented frames: %u, skipped frames: %u, uploaded bytes: %llu (%llu per presented frame)\n",
+        gRenderPresentedFrames,
+        gRenderSkippedFrames,
+        gRenderUploadedBytes,
+        averageBytes);
+}
+
+static void renderMarkDirty(int x, int y, int width, int height)
+{
+    SDL_Rect rect = { x, y, width, height };
+    if (SDL_RectEmpty(&rect)) {
+        return;
+    }
+
+    if (SDL_RectEmpty(&gRenderDirtyRect)) {
+        gRenderDirtyRect = rect;
+    } else {
+        SDL_UnionRect(&gRenderDirtyRect, &rect, &gRenderDirtyRect);
+    }
+}
+
+static void renderMarkAllDirty()
+{
+    if (gSdlTextureSurface != nullptr) {
+        renderMarkDirty(0, 0, gSdlTextureSurface->w, gSdlTextureSurface->h);
+    }
+}
+
 } // namespace fallout
@@ -50,6 +50,8 @@ int screenGetHeight();
 int screenGetVisibleHeight();
 void handleWindowSizeChanged();
 void renderPresent();
+void renderInvalidate();
+void renderPrintStats();
 
 } // namespace fallout
 
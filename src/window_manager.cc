@@ -280,6 +280,8 @@ void windowManagerExit(void)
                 internal_free(_screen_buffer);
             }
 
+            renderPrintStats();
+
             if (gVideoSystemExitProc != nullptr) {
                 gVideoSystemExitProc();
             }
@@ -11,6 +11,13 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fpattern/fpattern.h>
+
 #include "file_find.h"
 
 namespace fallout {
@@ -29,11 +36,31 @@ typedef struct XListEnumerationContext {
 
 typedef bool(XListEnumerationHandler)(XListEnumerationContext* context);
 
+// Location of .DAT entry in xbase index.
+typedef struct XBaseIndexEntry {
+    XBase* xbase;
+    DBaseEntry* entry;
+} XBaseIndexEntry;
+
+// Entry of the sorted list of indexed paths.
+typedef struct XBaseIndexPath {
+    // Lowercased path with `/` separators, used as a sort key.
+    std::string key;
+
+    // Original entry path.
+    const char* path;
+} XBaseIndexPath;
+
 static bool xlistEnumerate(const char* pattern, XListEnumerationHandler* handler, XList* xlist);
 static int xbaseMakeDirectory(const char* path);
 static void xbaseCloseAll();
 static void xbaseExitHandler(void);
 static bool xlistEnumerateHandler(XListEnumerationContext* context);
+static void xbaseIndexInvalidate();
+static void xbaseIndexBuild();
+static XBaseIndexEntry* xbaseIndexFind(const char* filePath);
+static std::string xbaseIndexMakeKey(const char* path, bool normalizeSeparators);
+static bool xbaseIndexEnumerate(const char* pattern, XListEnumerationHandler* handler, XListEnumerationContext* context);
 
 // 0x6B24D0
 static XBase* gXbaseHead;
@@ -41,6 +68,20 @@ static XBase* gXbaseHead;
 // 0x6B24D4
 static bool gXbaseExitHandlerRegistered;
 
+// Merged index of .DAT entries across all open xbases, keyed by lowercased
+// path. When the same path exists in several .DAT files, the one from xbase
+// with higher priority (closer to [gXbaseHead]) wins.
+//
+// The index is rebuilt lazily after xbases are opened, reordered, or closed.
+// Directory-based xbases are not indexed, they are probed on every open.
+static std::unordered_map<std::string, XBaseIndexEntry> gXbaseIndex;
+
+// Paths from [gXbaseIndex] sorted by [XBaseIndexPath::key], used to find
+// entries matching patterns without visiting every entry of every .DAT.
+static std::vector<XBaseIndexPath> gXbaseIndexPaths;
+
+static bool gXbaseIndexValid = false;
+
 // 0x4DED6C
 int xfileClose(XFile* stream)
 {
@@ -99,22 +140,29 @@ XFile* xfileOpen(const char* filePath, const char* mode)
     } else {
         // [filePath] is a relative path. Loop thru open xbases and attempt to
         // open [filePath] from appropriate xbase.
+        //
+        // CE: Index tells which dbase (if any) has this file, so other
+        // dbases are skipped without searching them.
+        XBaseIndexEntry* indexEntry = xbaseIndexFind(filePath);
+
         XBase* curr = gXbaseHead;
         while (curr != nullptr) {
             if (curr->isDbase) {
-                // Attempt to open dfile stream from dbase.
-                stream->dfile = dfileOpen(curr->dbase, filePath, mode);
-                if (stream->dfile != nullptr) {
-                    stream->type = XFILE_TYPE_DFILE;
-                    snprintf(path, sizeof(path), "%s", filePath);
-                    break;
+                if (indexEntry != nullptr && indexEntry->xbase == curr) {
+                    // Attempt to open dfile stream from dbase.
+                    stream->dfile = dfileOpenEntry(curr->dbase, indexEntry->entry, mode);
+                    if (stream->dfile != nullptr) {
+                        stream->type = XFILE_TYPE_DFILE;
+                        snprintf(path, sizeof(path), "%s", filePath);
+                        break;
+                    }
                 }
             } else {
                 // Build path relative to directory-based xbase.
                 snprintf(path, sizeof(path), "%s\\%s", curr->path, filePath);
 
                 // Attempt to open plain stream.
-                stream->file = compat_fopen(path, mode);
+                stream->file = compat_fopen_probe(path, mode);
                 if (stream->file != nullptr) {
                     stream->type = XFILE_TYPE_FILE;
                     break;
@@ -504,6 +552,8 @@ bool xbaseOpen(const char* path)
             prev->next = curr->next;
             curr->next = gXbaseHead;
             gXbaseHead = curr;
+
+            xbaseIndexInvalidate();
         }
         return true;
     }
@@ -527,6 +577,9 @@ bool xbaseOpen(const char* path)
         xbase->dbase = dbase;
         xbase->next = gXbaseHead;
         gXbaseHead = xbase;
+
+        xbaseIndexInvalidate();
+
         return true;
     }
 
@@ -550,6 +603,63 @@ bool xbaseOpen(const char* path)
     return false; // return false to trigger messages on game load
 }
 
+// Obtains contents of the file specified by [filePath] without copying.
+//
+// Files are resolved in the same order as [xfileOpen] does. Returns `nullptr`
+// if file is not found, or if the file which would be opened cannot be viewed
+// directly (file is not from memory mapped dbase, or it is compressed). The
+// returned data is valid until xbases are closed.
+const unsigned char* xbaseGetFileView(const char* filePath, size_t* sizePtr)
+{
+    assert(filePath); // "filename", "xfile.c", 162
+    assert(sizePtr);
+
+    // Views are only possible for memory mapped dbases, which are off by
+    // default, don't make every whole-file read pay for the lookup.
+    if (!dbaseHasMappedFiles()) {
+        return nullptr;
+    }
+
+    char drive[COMPAT_MAX_DRIVE];
+    char dir[COMPAT_MAX_DIR];
+    compat_splitpath(filePath, drive, dir, nullptr, nullptr);
+    if (drive[0] != '\0' || dir[0] == '\\' || dir[0] == '/' || dir[0] == '.') {
+        return nullptr;
+    }
+
+    XBaseIndexEntry* indexEntry = xbaseIndexFind(filePath);
+    if (indexEntry == nullptr) {
+        return nullptr;
+    }
+
+    const unsigned char* data;
+    size_t size;
+    if (!dbaseGetEntryView(indexEntry->xbase->dbase, indexEntry->entry, &data, &size)) {
+        return nullptr;
+    }
+
+    XBase* curr = gXbaseHead;
+    while (curr != nullptr) {
+        if (curr->isDbase) {
+            if (indexEntry->xbase == curr) {
+                *sizePtr = size;
+                return data;
+            }
+        } else {
+            char path[COMPAT_MAX_PATH];
+            snprintf(path, sizeof(path), "%s\\%s", curr->path, filePath);
+
+            // File in directory-based xbase overrides .DAT entries below.
+            if (compat_access(path, 0) == 0) {
+                return nullptr;
+            }
+        }
+        curr = curr->next;
+    }
+
+    return nullptr;
+}
+
 // 0x4DFB3C
 static bool xlistEnumerate(const char* pattern, XListEnumerationHandler* handler, XList* xlist)
 {
@@ -596,23 +706,16 @@ static bool xlistEnumerate(const char* pattern, XListEnumerationHandler* handler
         return findFindClose(&directoryFileFindData);
     }
 
+    // CE: Enumerate .DAT entries via index. Every path is reported once (even
+    // if it's present in several .DATs), and only entries sharing pattern's
+    // literal prefix are matched against pattern.
+    if (!xbaseIndexEnumerate(pattern, handler, &context)) {
+        return true;
+    }
+
     XBase* xbase = gXbaseHead;
     while (xbase != nullptr) {
-        if (xbase->isDbase) {
-            DFileFindData dbaseFindData;
-            if (dbaseFindFirstEntry(xbase->dbase, &dbaseFindData, pattern)) {
-                context.type = XFILE_ENUMERATION_ENTRY_TYPE_DFILE;
-
-                do {
-                    strcpy(context.name, dbaseFindData.fileName);
-                    if (!handler(&context)) {
-                        return dbaseFindClose(xbase->dbase, &dbaseFindData);
-                    }
-                } while (dbaseFindNextEntry(xbase->dbase, &dbaseFindData));
-
-                dbaseFindClose(xbase->dbase, &dbaseFindData);
-            }
-        } else {
+        if (!xbase->isDbase) {
             char path[COMPAT_MAX_PATH];
             snprintf(path, sizeof(path), "%s\\%s", xbase->path, pattern);
             compat_windows_path_to_native(path);
@@ -772,6 +875,8 @@ static void xbaseCloseAll()
     XBase* curr = gXbaseHead;
     gXbaseHead = nullptr;
 
+    xbaseIndexInvalidate();
+
     while (curr != nullptr) {
         XBase* next = curr->next;
 
@@ -823,4 +928,118 @@ static bool xlistEnumerateHandler(XListEnumerationContext* context)
     return true;
 }
 
+static void xbaseIndexInvalidate()
+{
+    gXbaseIndex.clear();
+    gXbaseIndexPaths.clear();
+    gXbaseIndexValid = false;
+}
+
+static void xbaseIndexBuild()
+{
+    gXbaseIndex.clear();
+    gXbaseIndexPaths.clear();
+
+    size_t entriesLength = 0;
+    for (XBase* curr = gXbaseHead; curr != nullptr; curr = curr->next) {
+        if (curr->isDbase) {
+            entriesLength += curr->dbase->entriesLength;
+        }
+    }
+
+    gXbaseIndex.reserve(entriesLength);
+    gXbaseIndexPaths.reserve(entriesLength);
+
+    // Walk xbases from the highest priority, so that the first inserted entry
+    // for every path is the one [xfileOpen] would open.
+    for (XBase* curr = gXbaseHead; curr != nullptr; curr = curr->next) {
+        if (!curr->isDbase) {
+            continue;
+        }
+
+        DBase* dbase = curr->dbase;
+        for (int index = 0; index < dbase->entriesLength; index++) {
+            DBaseEntry* entry = &(dbase->entries[index]);
+            auto result = gXbaseIndex.emplace(xbaseIndexMakeKey(entry->path, false), XBaseIndexEntry { curr, entry });
+            if (result.second) {
+                gXbaseIndexPaths.push_back(XBaseIndexPath { xbaseIndexMakeKey(entry->path, true), entry->path });
+            }
+        }
+    }
+
+    std::sort(gXbaseIndexPaths.begin(), gXbaseIndexPaths.end(), [](const XBaseIndexPath& a, const XBaseIndexPath& b) {
+        return a.key < b.key;
+    });
+
+    gXbaseIndexValid = true;
+}
+
+// Returns the highest priority .DAT entry for [filePath], or `nullptr` if no
+// open .DAT has it.
+static XBaseIndexEntry* xbaseIndexFind(const char* filePath)
+{
+    if (!gXbaseIndexValid) {
+        xbaseIndexBuild();
+    }
+
+    auto it = gXbaseIndex.find(xbaseIndexMakeKey(filePath, false));
+    if (it == gXbaseIndex.end()) {
+        return nullptr;
+    }
+
+    return &(it->second);
+}
+
+// Builds index key for [path]. .DAT entries are looked up case-insensitively
+// (see [dfileOpen]), so keys are lowercased. Separators are normalized for
+// sorting only, since [dfileOpen] does not treat them as equal.
+static std::string xbaseIndexMakeKey(const char* path, bool normalizeSeparators)
+{
+    std::string key(path);
+    for (char& ch : key) {
+        if (ch >= 'A' && ch <= 'Z') {
+            ch += 'a' - 'A';
+        } else if (normalizeSeparators && ch == '\\') {
+            ch = '/';
+        }
+    }
+    return key;
+}
+
+// Passes every indexed .DAT entry matching [pattern] to [handler].
+//
+// Returns `false` if handler requested to stop enumeration.
+static bool xbaseIndexEnumerate(const char* pattern, XListEnumerationHandler* handler, XListEnumerationContext* context)
+{
+    if (!gXbaseIndexValid) {
+        xbaseIndexBuild();
+    }
+
+    // Only entries starting with the literal part of the pattern can match,
+    // and they are adjacent in sorted list.
+    size_t prefixLength = strcspn(pattern, "*?[]!`~");
+    std::string prefix = xbaseIndexMakeKey(std::string(pattern, prefixLength).c_str(), true);
+
+    auto it = std::lower_bound(gXbaseIndexPaths.begin(), gXbaseIndexPaths.end(), prefix, [](const XBaseIndexPath& a, const std::string& b) {
+        return a.key < b;
+    });
+
+    context->type = XFILE_ENUMERATION_ENTRY_TYPE_DFILE;
+
+    for (; it != gXbaseIndexPaths.end(); it++) {
+        if (it->key.compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+
+        if (fpattern_match(pattern, it->path)) {
+            strcpy(context->name, it->path);
+            if (!handler(context)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 } // namespace fallout
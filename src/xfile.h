@@ -65,6 +65,7 @@ int xfileEof(XFile* stream);
 long xfileGetSize(XFile* stream);
 bool xbaseReopenAll(char* paths);
 bool xbaseOpen(const char* path);
+const unsigned char* xbaseGetFileView(const char* filePath, size_t* sizePtr);
 bool xlistInit(const char* pattern, XList* xlist);
 void xlistFree(XList* xlist);
 